@@ -79,6 +79,10 @@ parameters = [
     # ("head_pc_0.005", "parameters/memetic/head_pc_ls_0.005.json"),
     # ("head_pc_0.05", "parameters/memetic/head_pc_ls_0.05.json"),
     #
+    # # portfolio (independent vs cooperative, on DSJC500.5 and flat300_28_0)
+    # ("portfolio", "parameters/portfolio/portfolio.json"),
+    # ("portfolio_cooperative", "parameters/portfolio/portfolio_cooperative.json"),
+    #
     ("ahead_random", "parameters/memetic/ahead_random.json"),
     ("ahead_deleter", "parameters/memetic/ahead_deleter.json"),
     ("ahead_roulette", "parameters/memetic/ahead_roulette.json"),
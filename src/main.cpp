@@ -274,7 +274,7 @@ std::unique_ptr<Method> parse(int argc, const char **argv) {
         const long max_iterations = result["nb_iterations"].as<long>();
 
         const int rand_seed = result["rand_seed"].as<int>();
-        rd::generator.seed(rand_seed);
+        rd::seed(rand_seed);
 
         const std::string output_directory = result["output_directory"].as<std::string>();
         const std::string json_file = result["parameters"].as<std::string>();
@@ -0,0 +1,199 @@
+#include "DsaturFinisher.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "../representation/Graph.hpp"
+
+using namespace graph_instance;
+
+/** @brief Set of vertices of the subproblem, one bit per vertex*/
+typedef std::vector<uint64_t> Bitset;
+
+/**
+ * @brief Exact DSATUR branch and bound on the subproblem, the vertices outside of it
+ * keep their colors
+ */
+class DsaturSearch {
+    const ParamFinisher &_param;
+    const std::chrono::high_resolution_clock::time_point _max_time;
+    const int _nb_vertices;
+    const int _nb_colors;
+    /** @brief for each vertex of the subproblem, its neighbors in the subproblem*/
+    std::vector<Bitset> _adjacency;
+    /** @brief for each color, the vertices of the subproblem with a neighbor in it*/
+    std::vector<Bitset> _forbidden;
+    /** @brief for each depth, the forbidden vertices of the color tried at this depth*/
+    std::vector<Bitset> _saved;
+    /** @brief for each vertex of the subproblem, its color, -1 if not yet colored*/
+    std::vector<int> _colors;
+    /** @brief for each vertex of the subproblem, its degree in the subproblem*/
+    std::vector<int> _degrees;
+    long _nb_nodes{0};
+    bool _aborted{false};
+
+    bool is_forbidden(const int color, const int vertex) const {
+        return (_forbidden[color][vertex >> 6] >> (vertex & 63)) & 1;
+    }
+
+    bool search(const int depth);
+
+  public:
+    DsaturSearch(const ParamFinisher &param,
+                 const Solution &solution,
+                 const std::vector<int> &vertices);
+
+    /**
+     * @brief Color the subproblem
+     *
+     * @return true if the subproblem is colored, false if it has no solution or if the
+     * budget is exhausted (aborted)
+     */
+    bool run() {
+        return search(0);
+    }
+
+    bool aborted() const {
+        return _aborted;
+    }
+
+    /**
+     * @brief Color of the vertex of the subproblem
+     */
+    int color(const int vertex) const {
+        return _colors[vertex];
+    }
+};
+
+DsaturSearch::DsaturSearch(const ParamFinisher &param,
+                           const Solution &solution,
+                           const std::vector<int> &vertices)
+    : _param(param),
+      _max_time(std::chrono::high_resolution_clock::now() +
+                std::chrono::milliseconds(param.max_time)),
+      _nb_vertices(static_cast<int>(vertices.size())),
+      _nb_colors(solution.nb_colors()),
+      _adjacency(vertices.size(), Bitset((vertices.size() + 63) / 64, 0)),
+      _forbidden(static_cast<size_t>(_nb_colors), Bitset((vertices.size() + 63) / 64, 0)),
+      _saved(vertices.size(), Bitset((vertices.size() + 63) / 64, 0)),
+      _colors(vertices.size(), -1),
+      _degrees(vertices.size(), 0) {
+    std::vector<int> index(graph->nb_vertices, -1);
+    for (int i = 0; i < _nb_vertices; ++i) {
+        index[vertices[i]] = i;
+    }
+    for (int i = 0; i < _nb_vertices; ++i) {
+        for (const int neighbor : graph->neighborhood[vertices[i]]) {
+            const int j = index[neighbor];
+            if (j != -1) {
+                _adjacency[i][j >> 6] |= uint64_t{1} << (j & 63);
+                ++_degrees[i];
+            } else if (solution[neighbor] != -1) {
+                _forbidden[solution[neighbor]][i >> 6] |= uint64_t{1} << (i & 63);
+            }
+        }
+    }
+}
+
+bool DsaturSearch::search(const int depth) {
+    ++_nb_nodes;
+    if (_nb_nodes > _param.max_nodes or
+        ((_nb_nodes & 1023) == 0 and
+         std::chrono::high_resolution_clock::now() > _max_time)) {
+        _aborted = true;
+        return false;
+    }
+
+    // the vertex with the least available colors, then with the most neighbors
+    int vertex = -1;
+    int min_available = std::numeric_limits<int>::max();
+    for (int candidate = 0; candidate < _nb_vertices; ++candidate) {
+        if (_colors[candidate] != -1) {
+            continue;
+        }
+        int available = 0;
+        for (int color = 0; color < _nb_colors; ++color) {
+            available += not is_forbidden(color, candidate);
+        }
+        if (available == 0) {
+            return false;
+        }
+        if (available < min_available or
+            (available == min_available and _degrees[candidate] > _degrees[vertex])) {
+            min_available = available;
+            vertex = candidate;
+        }
+    }
+    if (vertex == -1) {
+        return true;
+    }
+
+    const auto &neighbors = _adjacency[vertex];
+    for (int color = 0; color < _nb_colors; ++color) {
+        if (is_forbidden(color, vertex)) {
+            continue;
+        }
+        auto &forbidden = _forbidden[color];
+        _saved[depth] = forbidden;
+        for (size_t word = 0; word < forbidden.size(); ++word) {
+            forbidden[word] |= neighbors[word];
+        }
+        _colors[vertex] = color;
+        if (search(depth + 1)) {
+            return true;
+        }
+        forbidden = _saved[depth];
+        if (_aborted) {
+            break;
+        }
+    }
+    _colors[vertex] = -1;
+    return false;
+}
+
+FinisherStatus dsatur_finisher(Solution &solution, const ParamFinisher &param) {
+    assert(solution.penalty() == 0);
+
+    // the uncolored vertices, then ring by ring the neighbors of the vertices of the
+    // previous ring in the colors where they are few
+    std::vector<int> vertices(solution.uncolored());
+    std::vector<bool> in_subproblem(graph->nb_vertices, false);
+    for (const int vertex : vertices) {
+        in_subproblem[vertex] = true;
+    }
+    size_t begin = 0;
+    for (int ring = 0; ring < param.depth; ++ring) {
+        const size_t end = vertices.size();
+        for (size_t i = begin; i < end; ++i) {
+            const int vertex = vertices[i];
+            for (const int neighbor : graph->neighborhood[vertex]) {
+                const int color = solution[neighbor];
+                if (color != -1 and color != solution[vertex] and
+                    not in_subproblem[neighbor] and
+                    solution.nb_conflicts(vertex, color) <= param.max_conflicts) {
+                    in_subproblem[neighbor] = true;
+                    vertices.emplace_back(neighbor);
+                }
+            }
+        }
+        begin = end;
+    }
+    if (static_cast<int>(vertices.size()) > param.max_vertices) {
+        return FinisherStatus::aborted;
+    }
+
+    DsaturSearch search(param, solution, vertices);
+    if (not search.run()) {
+        return search.aborted() ? FinisherStatus::aborted : FinisherStatus::infeasible;
+    }
+    std::vector<Coloration> colorations;
+    colorations.reserve(vertices.size());
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i) {
+        colorations.emplace_back(Coloration{vertices[i], search.color(i)});
+    }
+    solution.recolor(colorations);
+    assert(solution.is_legal());
+    return FinisherStatus::solved;
+}
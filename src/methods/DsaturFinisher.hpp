@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../representation/Solution.hpp"
+
+struct ParamFinisher {
+    /** @brief the finisher is called when the number of uncolored vertices is below or
+     * equal*/
+    const int max_uncolored;
+    /** @brief the neighbors of a vertex of the subproblem in an other color are added to
+     * the subproblem if they are at most max_conflicts in this color*/
+    const int max_conflicts;
+    /** @brief number of rings of neighbors added around the uncolored vertices*/
+    const int depth;
+    /** @brief maximum number of vertices of the subproblem*/
+    const int max_vertices;
+    /** @brief maximum number of nodes of the branch and bound*/
+    const long max_nodes;
+    /** @brief maximum time of the branch and bound in milliseconds*/
+    const long max_time;
+};
+
+/** @brief Result of the finisher*/
+enum class FinisherStatus {
+    /** @brief the solution is now legal*/
+    solved,
+    /** @brief the subproblem has no solution, the solution is unchanged*/
+    infeasible,
+    /** @brief the subproblem is too large or the budget is exhausted, the solution is
+     * unchanged*/
+    aborted,
+};
+
+/**
+ * @brief Try to complete a partial legal solution with few uncolored vertices
+ *
+ * The subproblem contains the uncolored vertices and param.depth rings of neighbors
+ * around them: the neighbors of a vertex of the previous ring in the other colors where
+ * they are at most param.max_conflicts (the ones a local search would move). The other
+ * vertices keep their colors. The subproblem is solved by an exact DSATUR branch and
+ * bound: the vertex with the least available colors is colored first, the available
+ * colors of each color are kept in bitsets over the vertices of the subproblem.
+ *
+ * Based on :
+ * Brélaz, D., 1979.
+ * New Methods to Color the Vertices of a Graph.
+ * Communications of the ACM 22, no. 4: 251–56.
+ * https://doi.org/10.1145/359094.359101
+ *
+ * @return FinisherStatus solved if the solution has been completed
+ */
+FinisherStatus dsatur_finisher(Solution &solution, const ParamFinisher &param);
@@ -0,0 +1,324 @@
+#include "ExtractionAlgorithm.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#include <fmt/printf.h>
+#pragma GCC diagnostic pop
+
+#include "../representation/Graph.hpp"
+#include "../representation/Parameters.hpp"
+#include "../utils/parse.hpp"
+#include "../utils/random_generator.hpp"
+
+using namespace graph_instance;
+using namespace parameters_search;
+
+ResidualGraph build_residual_graph(const std::vector<int> &vertices) {
+    const int nb_vertices = static_cast<int>(vertices.size());
+    std::vector<int> index(graph->nb_vertices, -1);
+    for (int vertex = 0; vertex < nb_vertices; ++vertex) {
+        index[vertices[vertex]] = vertex;
+    }
+    ResidualGraph residual{vertices, std::vector<int>(nb_vertices + 1, 0), {}};
+    for (int vertex = 0; vertex < nb_vertices; ++vertex) {
+        for (const int neighbor : graph->neighborhood[vertices[vertex]]) {
+            if (index[neighbor] != -1) {
+                residual.neighbors.emplace_back(index[neighbor]);
+            }
+        }
+        residual.offsets[vertex + 1] = static_cast<int>(residual.neighbors.size());
+    }
+    return residual;
+}
+
+std::vector<int> independent_set_tabu(const ResidualGraph &residual,
+                                      const ParamExtraction &param) {
+    const int nb_vertices = static_cast<int>(residual.vertices.size());
+    // for each vertex, 1 if in the set
+    std::vector<char> in_set(nb_vertices, 0);
+    // for each vertex, its number of neighbors in the set
+    std::vector<int> conflicts(nb_vertices, 0);
+    // vertices of the set, each vertex at its position
+    std::vector<int> members;
+    std::vector<int> position(nb_vertices, -1);
+    // number of edges inside the set
+    int penalty = 0;
+    // for each vertex, iteration until which it can not enter the set
+    std::vector<long> tabu(nb_vertices, 0);
+
+    const auto add = [&](const int vertex) {
+        in_set[vertex] = 1;
+        position[vertex] = static_cast<int>(members.size());
+        members.emplace_back(vertex);
+        penalty += conflicts[vertex];
+        for (int i = residual.offsets[vertex]; i < residual.offsets[vertex + 1]; ++i) {
+            ++conflicts[residual.neighbors[i]];
+        }
+    };
+    const auto remove = [&](const int vertex) {
+        in_set[vertex] = 0;
+        const int last = members.back();
+        members[position[vertex]] = last;
+        position[last] = position[vertex];
+        members.pop_back();
+        position[vertex] = -1;
+        penalty -= conflicts[vertex];
+        for (int i = residual.offsets[vertex]; i < residual.offsets[vertex + 1]; ++i) {
+            --conflicts[residual.neighbors[i]];
+        }
+    };
+    // vertex outside the set, not tabu, with the least conflicts (random on ties)
+    const auto best_outside = [&](const long iteration) {
+        int best_vertex = -1;
+        int best_conflicts = std::numeric_limits<int>::max();
+        int nb_ties = 0;
+        for (int vertex = 0; vertex < nb_vertices; ++vertex) {
+            if (in_set[vertex] or tabu[vertex] > iteration or
+                conflicts[vertex] > best_conflicts) {
+                continue;
+            }
+            if (conflicts[vertex] < best_conflicts) {
+                best_conflicts = conflicts[vertex];
+                nb_ties = 0;
+            }
+            ++nb_ties;
+            if (std::uniform_int_distribution<int>(1, nb_ties)(rd::generator) == 1) {
+                best_vertex = vertex;
+            }
+        }
+        return best_vertex;
+    };
+
+    // greedy maximal independent set in random order
+    std::vector<int> order(nb_vertices);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rd::generator);
+    for (const int vertex : order) {
+        if (conflicts[vertex] == 0) {
+            add(vertex);
+        }
+    }
+    std::vector<int> best_set(members);
+
+    long last_improvement = 0;
+    for (long iteration = 0; iteration - last_improvement < param.max_iterations;
+         ++iteration) {
+        if ((iteration & 0xFF) == 0 and parameters->time_limit_reached()) {
+            break;
+        }
+        if (penalty == 0) {
+            if (members.size() > best_set.size()) {
+                best_set = members;
+                last_improvement = iteration;
+            }
+            // search for a larger set
+            const int vertex = best_outside(iteration);
+            if (vertex == -1) {
+                break;
+            }
+            add(vertex);
+            continue;
+        }
+        // remove the most conflicting vertex of the set (random on ties)
+        int leaving = -1;
+        int max_conflicts = 0;
+        int nb_ties = 0;
+        for (const int vertex : members) {
+            if (conflicts[vertex] < max_conflicts) {
+                continue;
+            }
+            if (conflicts[vertex] > max_conflicts) {
+                max_conflicts = conflicts[vertex];
+                nb_ties = 0;
+            }
+            ++nb_ties;
+            if (std::uniform_int_distribution<int>(1, nb_ties)(rd::generator) == 1) {
+                leaving = vertex;
+            }
+        }
+        remove(leaving);
+        tabu[leaving] = iteration + param.tenure +
+                        std::uniform_int_distribution<int>(0, penalty)(rd::generator);
+        // then add the least conflicting vertex outside the set
+        const int entering = best_outside(iteration);
+        add(entering == -1 ? leaving : entering);
+    }
+    std::sort(best_set.begin(), best_set.end());
+    return best_set;
+}
+
+ExtractionAlgorithm::ExtractionAlgorithm(const ParamExtraction &param_)
+    : _best_solution(),
+      _param(param_),
+      _classes(),
+      _t_stage(std::chrono::high_resolution_clock::now()) {
+    fmt::print(parameters->output, "{}", header_csv());
+}
+
+long ExtractionAlgorithm::next_stage() {
+    const auto now = std::chrono::high_resolution_clock::now();
+    const long time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - _t_stage).count();
+    _t_stage = now;
+    return time;
+}
+
+void ExtractionAlgorithm::run() {
+    next_stage();
+    // with a target, at least one color is left to the residual graph
+    const int max_classes =
+        parameters->use_target ? parameters->nb_colors - 1 : graph->nb_vertices;
+    std::vector<int> residual_vertices(graph->nb_vertices);
+    std::iota(residual_vertices.begin(), residual_vertices.end(), 0);
+    std::vector<char> extracted(graph->nb_vertices, 0);
+
+    while (static_cast<int>(residual_vertices.size()) > _param.residual_vertices and
+           static_cast<int>(_classes.size()) < max_classes and
+           not parameters->time_limit_reached()) {
+        const ResidualGraph residual = build_residual_graph(residual_vertices);
+        const int stage = static_cast<int>(_classes.size());
+        std::vector<std::vector<int>> sets(_param.nb_starts);
+
+        const rd::SavedGenerator saved_generator;
+#pragma omp parallel for num_threads(_param.nb_threads) schedule(dynamic)
+        for (int start = 0; start < _param.nb_starts; ++start) {
+            // each start gets its own seed, independent of the thread running it
+            rd::seed_task({stage, start});
+            sets[start] = independent_set_tabu(residual, _param);
+        }
+
+        // largest set, the first one on ties
+        const auto &best_set = *std::max_element(
+            sets.begin(), sets.end(), [](const auto &set1, const auto &set2) {
+                return set1.size() < set2.size();
+            });
+        if (best_set.empty()) {
+            break;
+        }
+        std::vector<int> color_class;
+        color_class.reserve(best_set.size());
+        for (const int vertex : best_set) {
+            color_class.emplace_back(residual.vertices[vertex]);
+            extracted[residual.vertices[vertex]] = 1;
+        }
+        _classes.emplace_back(color_class);
+        residual_vertices.erase(std::remove_if(residual_vertices.begin(),
+                                               residual_vertices.end(),
+                                               [&](const int vertex) {
+                                                   return extracted[vertex] == 1;
+                                               }),
+                                residual_vertices.end());
+        fmt::print(parameters->output,
+                   "#extraction,{},{},{},{}\n",
+                   stage,
+                   color_class.size(),
+                   residual_vertices.size(),
+                   next_stage());
+    }
+
+    const int nb_classes = static_cast<int>(_classes.size());
+    std::unique_ptr<Method> method;
+    if (not residual_vertices.empty()) {
+        // build the residual graph from its compressed rows
+        const ResidualGraph residual = build_residual_graph(residual_vertices);
+        const int nb_vertices = static_cast<int>(residual_vertices.size());
+        std::vector<std::vector<bool>> adjacency_matrix(
+            nb_vertices, std::vector<bool>(nb_vertices, false));
+        std::vector<std::vector<int>> neighborhood(nb_vertices);
+        std::vector<int> degrees(nb_vertices, 0);
+        std::vector<std::pair<int, int>> edges_list;
+        edges_list.reserve(residual.neighbors.size() / 2);
+        for (int vertex = 0; vertex < nb_vertices; ++vertex) {
+            neighborhood[vertex].assign(
+                residual.neighbors.begin() + residual.offsets[vertex],
+                residual.neighbors.begin() + residual.offsets[vertex + 1]);
+            degrees[vertex] = static_cast<int>(neighborhood[vertex].size());
+            for (const int neighbor : neighborhood[vertex]) {
+                adjacency_matrix[vertex][neighbor] = true;
+                if (vertex < neighbor) {
+                    edges_list.emplace_back(vertex, neighbor);
+                }
+            }
+        }
+        const int nb_edges = static_cast<int>(edges_list.size());
+        std::unique_ptr<const Graph> original = std::move(graph);
+        graph = std::make_unique<Graph>(original->name + "_residual",
+                                        nb_vertices,
+                                        nb_edges,
+                                        adjacency_matrix,
+                                        neighborhood,
+                                        degrees,
+                                        edges_list);
+        fmt::print(parameters->output,
+                   "#residual_graph,{},{},{}\n",
+                   nb_vertices,
+                   nb_edges,
+                   next_stage());
+
+        // the method is built on the residual graph with the remaining colors, the bests
+        // shared by the threads are the ones of the residual graph during its run (the
+        // edge indices come with the graph)
+        const int best_penalty =
+            Solution::best_penalty.exchange(std::numeric_limits<int>::max());
+        const int best_nb_colors =
+            Solution::best_nb_colors.exchange(std::numeric_limits<int>::max());
+        parameters->nb_colors -= nb_classes;
+        method = get_method(
+            _param.residual_method, _param.max_time, _param.max_iterations_residual);
+        method->run();
+        parameters->nb_colors += nb_classes;
+        graph = std::move(original);
+        Solution::best_penalty.store(best_penalty);
+        Solution::best_nb_colors.store(best_nb_colors);
+        fmt::print(parameters->output, "#residual_method,{}\n", next_stage());
+    }
+
+    // lift the solution, the classes then the colors of the residual solution
+    _best_solution = Solution();
+    for (const auto &color_class : _classes) {
+        int color = -1;
+        for (const int vertex : color_class) {
+            color = _best_solution.add_to_color(vertex, color);
+        }
+    }
+    if (method) {
+        const Solution &solution = method->best_solution();
+        std::vector<int> colors(solution.nb_colors(), -1);
+        for (int vertex = 0; vertex < static_cast<int>(residual_vertices.size());
+             ++vertex) {
+            const int color = solution[vertex];
+            if (color != -1) {
+                colors[color] =
+                    _best_solution.add_to_color(residual_vertices[vertex], colors[color]);
+            }
+        }
+    }
+    assert(_best_solution.check_solution());
+    Solution::update_best_penalty(_best_solution.penalty());
+    if (_best_solution.is_legal()) {
+        Solution::update_best_nb_colors(_best_solution.nb_colors());
+    }
+    fmt::print(parameters->output, "#lift,{}\n", next_stage());
+    fmt::print(parameters->output, "{}", line_csv());
+}
+
+[[nodiscard]] const Solution &ExtractionAlgorithm::best_solution() const {
+    return _best_solution;
+}
+
+[[nodiscard]] const std::string ExtractionAlgorithm::header_csv() const {
+    return fmt::format("turn,time,{}\n", Solution::header_csv);
+}
+
+[[nodiscard]] const std::string ExtractionAlgorithm::line_csv() const {
+    return fmt::format(
+        "{},{},{}\n",
+        _classes.size(),
+        parameters->elapsed_time(std::chrono::high_resolution_clock::now()),
+        _best_solution.format());
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../representation/Method.hpp"
+#include "../representation/Solution.hpp"
+
+struct ParamExtraction {
+    const std::string name;
+    /** @brief the extraction stops when the residual graph has at most this number of
+     * vertices*/
+    const int residual_vertices;
+    /** @brief number of threads of the multi-start tabu search*/
+    const int nb_threads;
+    /** @brief number of starts of the tabu search for each extracted set*/
+    const int nb_starts;
+    /** @brief number of iterations without improvement before the end of a start*/
+    const long max_iterations;
+    /** @brief base tabu tenure of a vertex removed from the independent set*/
+    const int tenure;
+    /** @brief json of the method run on the residual graph*/
+    const std::string residual_method;
+    /** @brief time limit and number of iterations of the method on the residual graph*/
+    const int max_time;
+    const long max_iterations_residual;
+};
+
+/**
+ * @brief Residual graph in compressed sparse rows, the vertices are renumbered from 0
+ */
+struct ResidualGraph {
+    /** @brief for each vertex of the residual graph, its vertex in the graph*/
+    std::vector<int> vertices;
+    /** @brief neighbors of the vertex v are neighbors[offsets[v]] to
+     * neighbors[offsets[v + 1] - 1]*/
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+};
+
+/**
+ * @brief Build the subgraph induced by the vertices of the graph in O(n + m)
+ */
+[[nodiscard]] ResidualGraph build_residual_graph(const std::vector<int> &vertices);
+
+/**
+ * @brief Tabu search for a maximum independent set of the residual graph, return the
+ * vertices of the largest independent set found (vertices of the residual graph)
+ *
+ * The set has a fixed size k and the search minimizes the number of edges inside it by
+ * swapping its most conflicting vertex with the least conflicting vertex outside. When
+ * the set is independent, a vertex is added to search a set of size k + 1.
+ */
+[[nodiscard]] std::vector<int> independent_set_tabu(const ResidualGraph &residual,
+                                                    const ParamExtraction &param);
+
+/**
+ * @brief Method extracting independent sets before another method
+ *
+ * Large independent sets are extracted one by one, each one becomes a color class, until
+ * the residual graph has at most residual_vertices vertices. Each set is the best of
+ * nb_starts runs of independent_set_tabu shared between the threads. The residual method
+ * is then run on the residual graph, with the number of colors lowered by the number of
+ * classes, and its best solution is lifted back to the graph with the classes.
+ *
+ * The residual method prints its own lines on the residual graph, the time of each stage
+ * is printed on lines starting with # :
+ * #extraction,class,set size,residual vertices,time (ms)
+ * #residual_graph,nb vertices,nb edges,time (ms)
+ * #residual_method,time (ms)
+ * #lift,time (ms)
+ * followed by the line of the lifted solution.
+ *
+ * From :
+ * Wu, Qinghua, and Jin-Kao Hao.
+ * An Extraction and Expansion Approach for Graph Coloring.
+ * Asia-Pacific Journal of Operational Research 30, no. 05 (2013): 1350018.
+ */
+class ExtractionAlgorithm : public Method {
+
+    /** @brief Best found solution*/
+    Solution _best_solution;
+
+    const ParamExtraction _param;
+
+    /** @brief Extracted color classes (vertices of the graph)*/
+    std::vector<std::vector<int>> _classes;
+
+    /** @brief Start of the current stage*/
+    std::chrono::high_resolution_clock::time_point _t_stage;
+
+    /**
+     * @brief Return the time in milliseconds since the start of the stage and start a new
+     * stage
+     */
+    long next_stage();
+
+  public:
+    explicit ExtractionAlgorithm(const ParamExtraction &param_);
+
+    ~ExtractionAlgorithm() override = default;
+
+    /**
+     * @brief Run function for the method
+     */
+    void run() override;
+
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
+    /**
+     * @brief Return method header in csv format
+     *
+     * @return std::string method header in csv format
+     */
+    [[nodiscard]] const std::string header_csv() const override;
+
+    /**
+     * @brief Return method in csv format
+     *
+     * @return std::string method in csv format
+     */
+    [[nodiscard]] const std::string line_csv() const override;
+};
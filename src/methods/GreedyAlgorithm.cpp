@@ -28,6 +28,10 @@ void GreedyAlgorithm::run() {
     fmt::print(parameters->output, "{}", line_csv());
 }
 
+[[nodiscard]] const Solution &GreedyAlgorithm::best_solution() const {
+    return _best_solution;
+}
+
 [[nodiscard]] const std::string GreedyAlgorithm::header_csv() const {
     return fmt::format("time,{}\n", Solution::header_csv);
 }
@@ -27,6 +27,11 @@ class GreedyAlgorithm : public Method {
      */
     void run() override;
 
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
     /**
      * @brief Return method header in csv format
      *
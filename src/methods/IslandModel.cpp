@@ -0,0 +1,162 @@
+#include "IslandModel.hpp"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#include <fmt/printf.h>
+#pragma GCC diagnostic pop
+
+#include "../representation/Graph.hpp"
+#include "../representation/Parameters.hpp"
+#include "../utils/parse.hpp"
+#include "../utils/random_generator.hpp"
+
+using namespace graph_instance;
+using namespace parameters_search;
+
+Mailbox::~Mailbox() {
+    delete _migrant.load();
+}
+
+void Mailbox::post(const Solution &migrant) {
+    delete _migrant.exchange(new Solution(migrant), std::memory_order_acq_rel);
+}
+
+[[nodiscard]] std::unique_ptr<Solution> Mailbox::take() {
+    return std::unique_ptr<Solution>(
+        _migrant.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+IslandModel::IslandModel(const ParamIsland &param_)
+    : _best_solution(),
+      _param(param_),
+      _islands(),
+      _mailboxes(param_.nb_islands),
+      _socket(),
+      _t_best(std::chrono::high_resolution_clock::now()) {
+    fmt::print(parameters->output, "{}", header_csv());
+    const json data = json::parse(_param.memetic);
+    for (int island = 0; island < _param.nb_islands; ++island) {
+        // each island gets its own operators and adaptive helper
+        _islands.emplace_back(std::make_unique<MemeticAlgorithm>(
+            get_greedy_fct(data["initialization"]),
+            get_memetic(data, _param.max_time, _param.max_iterations),
+            island));
+    }
+    if (_param.port != -1) {
+        _socket = std::make_unique<MigrationSocket>(_param.port, _param.peers);
+    }
+}
+
+void IslandModel::update_best_score(const int island) {
+    const Solution &solution = _islands[island]->best_solution();
+#pragma omp critical(island_best)
+    {
+        ++_turn;
+        if (std::max(_best_solution.penalty(), _best_solution.nb_uncolored()) >
+            std::max(solution.penalty(), solution.nb_uncolored())) {
+            _t_best = std::chrono::high_resolution_clock::now();
+            _best_solution = solution;
+            fmt::print(parameters->output, "{}", line_csv());
+            if (_best_solution.penalty() == 0 and _best_solution.nb_uncolored() == 0) {
+                _solved.store(true, std::memory_order_release);
+            }
+        }
+    }
+}
+
+void IslandModel::solved_by_peer(const Solution &solution) {
+#pragma omp critical(island_best)
+    {
+        if (not _solved.load(std::memory_order_acquire)) {
+            _t_best = std::chrono::high_resolution_clock::now();
+            _best_solution = solution;
+            fmt::print(parameters->output, "{}", line_csv());
+            _solved.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void IslandModel::migrate(const int island) {
+    const Solution &migrant = _islands[island]->emigrant(_param.most_distant);
+    const int nb_peers = _socket ? _socket->nb_peers() : 0;
+    if (not _param.random_topology) {
+        if (island == _param.nb_islands - 1 and nb_peers > 0) {
+            // the ring goes on in the next processes
+            for (int peer = 0; peer < nb_peers; ++peer) {
+                _socket->send(migrant, peer);
+            }
+        } else {
+            _mailboxes[(island + 1) % _param.nb_islands].post(migrant);
+        }
+        return;
+    }
+    // any island but the current one, or any peer
+    int destination = std::uniform_int_distribution<int>(
+        0, _param.nb_islands - 2 + nb_peers)(rd::generator);
+    if (destination >= _param.nb_islands - 1) {
+        _socket->send(migrant, destination - (_param.nb_islands - 1));
+        return;
+    }
+    if (destination >= island) {
+        ++destination;
+    }
+    _mailboxes[destination].post(migrant);
+}
+
+void IslandModel::run() {
+    const rd::SavedGenerator saved_generator;
+#pragma omp parallel for num_threads(_param.nb_islands) schedule(static, 1)
+    for (int island = 0; island < _param.nb_islands; ++island) {
+        // each island gets its own seed, independent of the thread running it
+        rd::seed_task({island});
+        MemeticAlgorithm &memetic = *_islands[island];
+        memetic.initialize();
+        update_best_score(island);
+        while (memetic.stop_condition() and
+               not _solved.load(std::memory_order_acquire)) {
+            memetic.run_turn();
+            if (_param.migration_interval > 0 and
+                (_param.nb_islands > 1 or (_socket and _socket->nb_peers() > 0)) and
+                memetic.turn() % _param.migration_interval == 0) {
+                migrate(island);
+            }
+            if (auto migrant = _mailboxes[island].take()) {
+                memetic.immigrate(*migrant);
+            }
+            if (_socket) {
+                if (auto migrant = _socket->receive()) {
+                    if (migrant->penalty() == 0 and migrant->nb_uncolored() == 0) {
+                        // another process solved the instance
+                        solved_by_peer(*migrant);
+                        break;
+                    }
+                    memetic.immigrate(*migrant);
+                }
+            }
+            update_best_score(island);
+        }
+    }
+    if (_socket and _solved.load(std::memory_order_acquire)) {
+        // stop the other processes, sent several times as UDP may drop a datagram,
+        // the stop stays best effort and a process missing it runs until its time limit
+        for (int message = 0; message < nb_stop_messages; ++message) {
+            for (int peer = 0; peer < _socket->nb_peers(); ++peer) {
+                _socket->send(_best_solution, peer);
+            }
+        }
+    }
+    fmt::print(parameters->output, "{}", line_csv());
+}
+
+[[nodiscard]] const Solution &IslandModel::best_solution() const {
+    return _best_solution;
+}
+
+[[nodiscard]] const std::string IslandModel::header_csv() const {
+    return fmt::format("turn,time,{}\n", Solution::header_csv);
+}
+
+[[nodiscard]] const std::string IslandModel::line_csv() const {
+    return fmt::format(
+        "{},{},{}\n", _turn, parameters->elapsed_time(_t_best), _best_solution.format());
+}
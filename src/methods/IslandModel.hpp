@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../representation/Method.hpp"
+#include "../representation/Solution.hpp"
+#include "../utils/migration_socket.hpp"
+#include "MemeticAlgorithm.hpp"
+
+struct ParamIsland {
+    const std::string name;
+    /** @brief number of populations, each one evolving on its own thread*/
+    const int nb_islands;
+    /** @brief number of turns of an island between two migrations (0 for no migration)*/
+    const long migration_interval;
+    /** @brief migrant sent, the best individual or the one the farthest from the others*/
+    const bool most_distant;
+    /** @brief destination of the migrants, the next island on a ring or a random one*/
+    const bool random_topology;
+    /** @brief json of the memetic algorithm of each island*/
+    const std::string memetic;
+    /** @brief UDP port receiving the migrants of the other processes (-1 for a single
+     * process)*/
+    const int port;
+    /** @brief processes receiving the migrants of this one (host:port)*/
+    const std::vector<std::string> peers;
+    const int max_time;
+    const long max_iterations;
+};
+
+/**
+ * @brief Mailbox of an island, holding the last migrant sent to it
+ *
+ * Posting and taking only exchange a pointer, a migrant not taken before the next one is
+ * posted is dropped.
+ */
+class Mailbox {
+    std::atomic<Solution *> _migrant{nullptr};
+
+  public:
+    Mailbox() = default;
+
+    ~Mailbox();
+
+    Mailbox(const Mailbox &other) = delete;
+    Mailbox &operator=(const Mailbox &other) = delete;
+
+    /**
+     * @brief Leave a copy of the migrant in the mailbox
+     */
+    void post(const Solution &migrant);
+
+    /**
+     * @brief Take the migrant of the mailbox, nullptr if there is none
+     */
+    [[nodiscard]] std::unique_ptr<Solution> take();
+};
+
+/**
+ * @brief Method for an island model of memetic algorithms
+ *
+ * nb_islands memetic algorithms, with their own population, random stream and adaptive
+ * helper, run turn by turn on their own thread (the parallel loops of each memetic run
+ * on its thread). Every migration_interval turns, an island posts a migrant in the
+ * mailbox of the next island (ring) or of a random other island, and each island inserts
+ * the migrant of its mailbox after its turns. The search stops for all the islands as
+ * soon as one of them finds a legal solution.
+ *
+ * With HEAD islands (population of 2), a single job uses as many cores as islands.
+ *
+ * With a port, the islands of several gc processes cooperate through a MigrationSocket.
+ * On a ring, the last island sends its migrants to the peers instead of the first
+ * island. On a random topology, the peers are destinations like the other islands.
+ * Each island inserts one migrant received from the peers after its turns, and a legal
+ * solution is sent to the peers to stop them.
+ */
+class IslandModel : public Method {
+
+    /** @brief Best found solution*/
+    Solution _best_solution;
+
+    const ParamIsland _param;
+
+    /** @brief Memetic algorithm of each island*/
+    std::vector<std::unique_ptr<MemeticAlgorithm>> _islands;
+    /** @brief Mailbox of each island*/
+    std::vector<Mailbox> _mailboxes;
+    /** @brief Socket to the other processes, nullptr for a single process*/
+    std::unique_ptr<MigrationSocket> _socket;
+
+    /** @brief Time before founding best score*/
+    std::chrono::high_resolution_clock::time_point _t_best;
+    /** @brief Number of turns of all the islands*/
+    long _turn = 0;
+    /** @brief Set when an island, or another process, finds a legal solution*/
+    std::atomic<bool> _solved{false};
+    /** @brief Number of times the legal solution is sent to stop the other processes*/
+    static constexpr int nb_stop_messages = 3;
+
+    /**
+     * @brief Count the turn of the island and keep its best solution if it is better
+     */
+    void update_best_score(const int island);
+
+    /**
+     * @brief Keep the legal solution received from another process and stop the islands
+     */
+    void solved_by_peer(const Solution &solution);
+
+    /**
+     * @brief Send the migrant of the island to its destination
+     */
+    void migrate(const int island);
+
+  public:
+    explicit IslandModel(const ParamIsland &param_);
+
+    ~IslandModel() override = default;
+
+    /**
+     * @brief Run function for the method
+     */
+    void run() override;
+
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
+    /**
+     * @brief Return method header in csv format
+     *
+     * @return std::string method header in csv format
+     */
+    [[nodiscard]] const std::string header_csv() const override;
+
+    /**
+     * @brief Return method in csv format
+     *
+     * @return std::string method in csv format
+     */
+    [[nodiscard]] const std::string line_csv() const override;
+};
@@ -2,7 +2,10 @@
 
 #include <algorithm>
 #include <cassert>
-#include <map>
+#include <cmath>
+#include <cstdint>
+
+#include <omp.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Weffc++"
@@ -37,7 +40,15 @@ void LocalSearchAlgorithm::run() {
     assert(_best_solution.check_solution());
     fmt::print(parameters->output, "{}", line_csv());
 
-    _local_search.run(_best_solution);
+    // the local search returns its best legal solution, if any, without target
+    const auto legal_solution = _local_search.run(_best_solution);
+    if (legal_solution) {
+        _best_solution = legal_solution.value();
+    }
+}
+
+[[nodiscard]] const Solution &LocalSearchAlgorithm::best_solution() const {
+    return _best_solution;
 }
 
 [[nodiscard]] const std::string LocalSearchAlgorithm::header_csv() const {
@@ -51,6 +62,119 @@ void LocalSearchAlgorithm::run() {
         _best_solution.format());
 }
 
+bool stop_local_search(const ParamLS &param,
+                       const std::chrono::high_resolution_clock::time_point &max_time) {
+    return (param.cancel and param.cancel->load(std::memory_order_relaxed)) or
+           parameters->time_limit_reached_sub_method(max_time);
+}
+
+void legal_solution_found(const ParamLS &param) {
+    if (param.cancel) {
+        param.cancel->store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Call the finisher of param on the solution if it has a new best number of
+ * uncolored vertices, small enough
+ */
+void try_finisher(Solution &solution, const int best_found, const ParamLS &param) {
+    if (param.finisher and solution.nb_uncolored() != 0 and
+        solution.nb_uncolored() < best_found and
+        solution.nb_uncolored() <= param.finisher->max_uncolored) {
+        dsatur_finisher(solution, param.finisher.value());
+        assert(solution.check_solution());
+    }
+}
+
+/**
+ * @brief Return the vertices to evaluate, all of them or, with param.sampling, a random
+ * sample (sorted, without duplicates) drawn with replacement in the sample buffer
+ */
+const std::vector<int> &sample_vertices(const std::vector<int> &vertices,
+                                        const ParamLS &param,
+                                        std::vector<int> &sample) {
+    if (not param.sampling) {
+        return vertices;
+    }
+    const int nb_vertices = static_cast<int>(vertices.size());
+    const int nb_samples =
+        std::max(param.sampling->size,
+                 static_cast<int>(std::ceil(param.sampling->ratio * nb_vertices)));
+    if (nb_samples >= nb_vertices) {
+        return vertices;
+    }
+    std::uniform_int_distribution<int> distribution(0, nb_vertices - 1);
+    sample.clear();
+    for (int i = 0; i < nb_samples; ++i) {
+        sample.emplace_back(vertices[distribution(rd::generator)]);
+    }
+    std::sort(sample.begin(), sample.end());
+    sample.erase(std::unique(sample.begin(), sample.end()), sample.end());
+    return sample;
+}
+
+/**
+ * @brief Detect the stagnation of a local search, no improvement of its best solution for
+ * param.stagnation_iterations iterations or param.stagnation_time milliseconds
+ */
+class Stagnation {
+    const ParamLS &_param;
+    const Solution &_best_solution;
+    long _last_improvement_turn{0};
+    std::chrono::high_resolution_clock::time_point _last_improvement_time;
+    long _last_exchange_turn{0};
+    bool _exchange_stagnation{false};
+
+  public:
+    explicit Stagnation(const ParamLS &param, const Solution &best_solution)
+        : _param(param),
+          _best_solution(best_solution),
+          _last_improvement_time(std::chrono::high_resolution_clock::now()) {}
+
+    /**
+     * @brief Start again the detection, when the local search restarts from turn 0
+     */
+    void reset() {
+        improvement(0);
+        _last_exchange_turn = 0;
+    }
+
+    /**
+     * @brief Record an improvement of the best solution
+     */
+    void improvement(const long turn) {
+        _last_improvement_turn = turn;
+        if (_param.stagnation_time > 0) {
+            _last_improvement_time = std::chrono::high_resolution_clock::now();
+        }
+    }
+
+    /**
+     * @brief Return true if the local search must stop as it stagnates, in a cooperative
+     * portfolio the best solution goes to the exchange every interval iterations and the
+     * portfolio decides of the stagnation
+     */
+    bool reached(const long turn) {
+        if (_param.exchange and not _exchange_stagnation and
+            turn > _last_exchange_turn and turn % _param.exchange->interval == 0) {
+            _last_exchange_turn = turn;
+            _exchange_stagnation = _param.exchange->function(_best_solution);
+        }
+        if (_exchange_stagnation) {
+            return true;
+        }
+        if (_param.stagnation_iterations > 0 and
+            turn - _last_improvement_turn >= _param.stagnation_iterations) {
+            return true;
+        }
+        return _param.stagnation_time > 0 and
+               std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::high_resolution_clock::now() - _last_improvement_time)
+                       .count() >= _param.stagnation_time;
+    }
+};
+
 std::optional<Solution> partial_col(Solution &best_solution, const ParamLS &param) {
     const auto max_time =
         std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
@@ -80,9 +204,10 @@ std::optional<Solution> partial_col(Solution &best_solution, const ParamLS &para
 
     Solution solution = best_solution;
     long turn = 0;
+    Stagnation stagnation(param, best_solution);
 
-    while (not parameters->time_limit_reached_sub_method(max_time) and
-           turn < param.max_iterations and
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
            not(best_solution.is_legal() and
                best_solution.nb_colors() == parameters->nb_colors)) {
 
@@ -102,8 +227,10 @@ std::optional<Solution> partial_col(Solution &best_solution, const ParamLS &para
         std::uniform_int_distribution<int> distribution_colors(0,
                                                                solution.nb_colors() - 1);
         turn = 0;
-        while (not parameters->time_limit_reached_sub_method(max_time) and
-               turn < param.max_iterations and not best_solution.is_legal()) {
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
 
             ++turn;
 
@@ -151,12 +278,15 @@ std::optional<Solution> partial_col(Solution &best_solution, const ParamLS &para
 
             assert(solution.check_solution());
 
+            try_finisher(solution, best_found, param);
+
             if (solution.nb_uncolored() < best_found) {
                 best_found = solution.nb_uncolored();
                 best_solution = solution;
                 best_time =
                     parameters->elapsed_time(std::chrono::high_resolution_clock::now());
                 best_turn = turn;
+                stagnation.improvement(turn);
                 if (param.verbose) {
                     print_result_ls(best_time, best_solution, turn);
                 }
@@ -164,6 +294,7 @@ std::optional<Solution> partial_col(Solution &best_solution, const ParamLS &para
         }
         if (solution.is_legal()) {
             best_legal_solution = solution;
+            legal_solution_found(param);
             best_legal_time = best_time;
             best_legal_turn = best_turn;
         }
@@ -182,6 +313,24 @@ std::optional<Solution> partial_col(Solution &best_solution, const ParamLS &para
     return best_legal_solution;
 }
 
+/**
+ * @brief Grenade move (partial col optimized) updating the hash of the reactive tabu
+ */
+void grenade_move_reactive(Solution &solution,
+                           const int vertex,
+                           const int color,
+                           std::optional<ReactiveTabu> &reactive) {
+    if (reactive) {
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            if (solution[neighbor] == color) {
+                reactive->move(neighbor, color, -1);
+            }
+        }
+        reactive->move(vertex, -1, color);
+    }
+    solution.grenade_move_optimized_2(vertex, color);
+}
+
 std::optional<Solution> partial_col_optimized(Solution &best_solution,
                                               const ParamLS &param) {
     const auto max_time =
@@ -212,9 +361,15 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
 
     Solution solution = best_solution;
     long turn = 0;
+    Stagnation stagnation(param, best_solution);
 
-    while (not parameters->time_limit_reached_sub_method(max_time) and
-           turn < param.max_iterations and
+    std::optional<ReactiveTabu> reactive = std::nullopt;
+    if (param.reactive) {
+        reactive.emplace(param.reactive.value());
+    }
+
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
            not(best_solution.is_legal() and
                best_solution.nb_colors() == parameters->nb_colors)) {
 
@@ -233,19 +388,29 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
 
         std::uniform_int_distribution<int> distribution_colors(0,
                                                                solution.nb_colors() - 1);
-        solution.init_deltas_optimized();
+        // the deltas are kept when resuming from a perturbed solution (ILS)
+        if (not solution.deltas_up_to_date()) {
+            solution.init_deltas_optimized();
+        }
         assert(solution.check_solution());
+        if (reactive) {
+            reactive->reset(solution);
+        }
+        std::vector<int> sample;
 
         turn = 0;
-        while (not parameters->time_limit_reached_sub_method(max_time) and
-               turn < param.max_iterations and not best_solution.is_legal()) {
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
 
             ++turn;
 
             int best_current = std::numeric_limits<int>::max();
             std::vector<Coloration> best_colorations;
 
-            for (const int vertex : solution.uncolored()) {
+            const auto &vertices = sample_vertices(solution.uncolored(), param, sample);
+            for (const int vertex : vertices) {
                 const int nb_conflict = solution.best_delta(vertex);
                 if (nb_conflict > best_current) {
                     continue;
@@ -305,7 +470,7 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
             }
 
             const auto [vertex, color] = rd::choice(best_colorations);
-            solution.grenade_move_optimized_2(vertex, color);
+            grenade_move_reactive(solution, vertex, color, reactive);
 
             // Block neighbor of the best move from coming to the color
             for (const int neighbor : graph->neighborhood[vertex]) {
@@ -313,10 +478,28 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
                     static_cast<long>(param.alpha *
                                       static_cast<double>(solution.nb_uncolored())) +
                     distribution_tabu(rd::generator);
+                if (reactive) {
+                    t_tenure = reactive->tenure(t_tenure);
+                }
                 tabu_matrix[neighbor][color] = turn + t_tenure;
             }
 
+            // escape from the cycle with random grenade moves
+            if (reactive and reactive->visit(turn)) {
+                for (int i = 0; i < param.reactive->escape_moves; ++i) {
+                    if (solution.uncolored().empty()) {
+                        break;
+                    }
+                    grenade_move_reactive(solution,
+                                          rd::choice(solution.uncolored()),
+                                          distribution_colors(rd::generator),
+                                          reactive);
+                }
+                reactive->reset(solution);
+            }
+
             assert(solution.check_solution());
+            assert(not reactive or reactive->check_hash(solution));
 
             if (solution.nb_uncolored() < best_found) {
                 best_found = solution.nb_uncolored();
@@ -324,6 +507,7 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
                 best_time =
                     parameters->elapsed_time(std::chrono::high_resolution_clock::now());
                 best_turn = turn;
+                stagnation.improvement(turn);
                 if (param.verbose) {
                     print_result_ls(best_time, best_solution, turn);
                 }
@@ -331,6 +515,7 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
         }
         if (solution.is_legal()) {
             best_legal_solution = solution;
+            legal_solution_found(param);
             best_legal_time = best_time;
             best_legal_turn = best_turn;
         }
@@ -348,7 +533,67 @@ std::optional<Solution> partial_col_optimized(Solution &best_solution,
     return best_legal_solution;
 }
 
-bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list) {
+/**
+ * @brief Buffers of the moves of partial ts, allocated once for the search
+ */
+struct PartialTSBuffers {
+    /** @brief for each color, number of neighbors that must be relocated
+     * (reset to 0 after each vertex)*/
+    std::vector<int> relocated{};
+    /** @brief for each color, number of neighbors that would become uncolored
+     * (reset to 0 after each vertex)*/
+    std::vector<int> costs{};
+    /** @brief list(vertex, color) for M3 grenade*/
+    std::vector<std::tuple<int, int>> grenade_one_lost{};
+    /** @brief candidates of M4*/
+    std::vector<int> candidates{};
+    /** @brief colors of the best grenade of M6*/
+    std::vector<int> best_grenade{};
+    /** @brief all the vertices, shuffled lazily by M5*/
+    std::vector<int> vertices{};
+    /** @brief maximum depth of the grenade cascades, 0 for unbounded*/
+    int max_cascade_depth = 0;
+    /** @brief number of grenade moves applied*/
+    long nb_cascades = 0;
+    /** @brief sum of the lengths of the grenade cascades*/
+    long total_cascade_length = 0;
+    /** @brief length of the longest grenade cascade*/
+    int max_cascade_length = 0;
+};
+
+/**
+ * @brief Apply the grenade move and record the length of its cascade
+ */
+void grenade(Solution &solution,
+             const int vertex,
+             const int color,
+             PartialTSBuffers &buffers) {
+    const int length =
+        solution.grenade_move_optimized(vertex, color, buffers.max_cascade_depth);
+    ++buffers.nb_cascades;
+    buffers.total_cascade_length += length;
+    buffers.max_cascade_length = std::max(buffers.max_cascade_length, length);
+}
+
+/**
+ * @brief Reset the counters of the colors of the neighbors of the vertex
+ */
+void reset_neighbor_colors(const Solution &solution,
+                           const int vertex,
+                           PartialTSBuffers &buffers) {
+    for (const auto &neighbor : graph->neighborhood[vertex]) {
+        const int neighbor_color = solution[neighbor];
+        if (neighbor_color != -1) {
+            buffers.relocated[neighbor_color] = 0;
+            buffers.costs[neighbor_color] = 0;
+        }
+    }
+}
+
+bool M_1_2_3(Solution &solution,
+             const long turn,
+             std::vector<long> &tabu_list,
+             PartialTSBuffers &buffers) {
     // M1 : moves a vertex to a free color
 
     // M2 : moves a vertex and moves its neighbors to other colors (perfect grenade)
@@ -357,23 +602,23 @@ bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list)
     // neighbors to other colors except for one that become uncolored (grenade one lost)
 
     // list(vertex, color) for M3 grenade
-    std::vector<std::tuple<int, int>> grenade_one_lost;
+    auto &grenade_one_lost = buffers.grenade_one_lost;
+    grenade_one_lost.clear();
+    // costs counts the number of neighbors in the tabu list
+    auto &costs = buffers.costs;
+    // relocated counts the number of neighbors that must be relocated for each color
+    auto &relocated = buffers.relocated;
     for (const auto &vertex : solution.uncolored()) {
 
         // M1 : move vertex to a color with no neighbors
         const auto &possible_colors = solution.possible_colors(vertex);
         if (not possible_colors.empty()) {
-            solution.grenade_move_optimized(vertex, rd::choice(possible_colors));
+            grenade(solution, vertex, rd::choice(possible_colors), buffers);
             // fmt::print("M1 : vertex {} to color {}\n", vertex, solution[vertex]);
             return true;
         }
 
         // M2 : move vertex to a color with neighbors (prefect grenade)
-
-        // costs counts the number of neighbors in the tabu list
-        std::vector<int> costs(solution.nb_colors(), 0);
-        // relocated counts the number of neighbors that must be relocated for each color
-        std::vector<int> relocated(solution.nb_colors(), 0);
         for (const auto &neighbor : graph->neighborhood[vertex]) {
             // if neighbor is unassigned, we don't care
             int neighbor_color = solution[neighbor];
@@ -383,7 +628,7 @@ bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list)
 
             // if the number of free colors for the neighbor is > 0, we increase the
             // number of relocated for the color
-            if (not solution.possible_colors(neighbor).empty()) {
+            if (solution.nb_free_colors(neighbor) > 0) {
                 ++relocated[neighbor_color];
             } else if (tabu_list[neighbor] < turn) {
                 ++relocated[neighbor_color];
@@ -398,8 +643,9 @@ bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list)
 
             // if all neighbors can be relocated, we apply the move
             if (costs[neighbor_color] == 0) {
+                reset_neighbor_colors(solution, vertex, buffers);
                 // we apply the grenade move on the vertex and neighbors
-                solution.grenade_move_optimized(vertex, neighbor_color);
+                grenade(solution, vertex, neighbor_color, buffers);
                 // fmt::print("M2 : vertex {} to color {}\n", vertex, neighbor_color);
                 return true;
             }
@@ -408,6 +654,7 @@ bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list)
                 grenade_one_lost.emplace_back(vertex, neighbor_color);
             }
         }
+        reset_neighbor_colors(solution, vertex, buffers);
     }
 
     // M3 : move vertex to a color with neighbors, only one neighbor become uncolored
@@ -415,7 +662,7 @@ bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list)
         return false;
     }
     const auto [vertex, min_color] = rd::choice(grenade_one_lost);
-    solution.grenade_move_optimized(vertex, min_color);
+    grenade(solution, vertex, min_color, buffers);
     tabu_list[vertex] = turn + static_cast<long>(solution.nb_colors());
     // fmt::print("M3 : vertex {} to color {}\n", vertex, min_color);
     return true;
@@ -424,16 +671,24 @@ bool M_1_2_3(Solution &solution, const long turn, std::vector<long> &tabu_list)
 bool M_4(Solution &solution,
          const long turn,
          std::vector<long> &tabu_list,
-         const std::vector<int> &vertices) {
+         PartialTSBuffers &buffers) {
     // M4 : for each colored vertex not tabu with free colors, move it to an other color
     // move at most |non_empty_colors| vertices
+    // the candidates are drawn in random order from the free vertices
+    auto &candidates = buffers.candidates;
+    candidates = solution.free_vertices();
     int counter = 0;
-    for (const auto &vertex : vertices) {
-        if (not solution.possible_colors(vertex).empty() and tabu_list[vertex] < turn and
+    for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
+        std::uniform_int_distribution<int> distribution(
+            i, static_cast<int>(candidates.size()) - 1);
+        std::swap(candidates[i], candidates[distribution(rd::generator)]);
+        const int vertex = candidates[i];
+        // the previous moves may have changed the free colors of the vertex
+        if (solution.nb_free_colors(vertex) > 0 and tabu_list[vertex] < turn and
             solution[vertex] != -1) {
             tabu_list[vertex] = turn + static_cast<long>(solution.nb_colors());
-            solution.grenade_move_optimized(vertex,
-                                            rd::choice(solution.possible_colors(vertex)));
+            grenade(
+                solution, vertex, rd::choice(solution.possible_colors(vertex)), buffers);
             // fmt::print("M4 : vertex {} to color {}\n", vertex, solution[vertex]);
             ++counter;
             if (counter == solution.nb_colors()) {
@@ -447,52 +702,68 @@ bool M_4(Solution &solution,
 bool M_5(Solution &solution,
          const long turn,
          std::vector<long> &tabu_list,
-         const std::vector<int> &vertices) {
+         PartialTSBuffers &buffers) {
     // M5 : for each vertex try to relocate its neighbors
-
-    for (const auto &vertex : vertices) {
-        const bool has_free_colors = not solution.possible_colors(vertex).empty();
+    // the vertices are shuffled as they are visited
+    auto &vertices = buffers.vertices;
+    auto &relocated = buffers.relocated;
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i) {
+        std::uniform_int_distribution<int> distribution(
+            i, static_cast<int>(vertices.size()) - 1);
+        std::swap(vertices[i], vertices[distribution(rd::generator)]);
+        const int vertex = vertices[i];
+
+        const bool has_free_colors = solution.nb_free_colors(vertex) > 0;
         const bool is_not_tabu = tabu_list[vertex] >= turn;
         const bool is_not_colored = solution[vertex] == -1;
 
         if (has_free_colors or is_not_tabu or is_not_colored) {
             continue;
         }
-        std::vector<int> relocated(solution.nb_colors(), 0);
+        // without free neighbors, no neighbors can be relocated
+        if (solution.nb_free_neighbors(vertex) == 0) {
+            continue;
+        }
         for (const auto &neighbor : graph->neighborhood[vertex]) {
             int c_neighbor = solution[neighbor];
             if (c_neighbor == -1)
                 continue;
-            if (not solution.possible_colors(neighbor).empty()) {
+            if (solution.nb_free_colors(neighbor) > 0) {
                 ++relocated[c_neighbor];
             }
 
             if (relocated[c_neighbor] == solution.nb_conflicts(vertex, c_neighbor)) {
-                solution.grenade_move_optimized(vertex, c_neighbor);
+                reset_neighbor_colors(solution, vertex, buffers);
+                grenade(solution, vertex, c_neighbor, buffers);
                 tabu_list[vertex] = turn + static_cast<long>(solution.nb_colors());
                 // fmt::print("M5 : vertex {} to color {}\n", vertex, c_neighbor);
                 return true;
             }
         }
+        reset_neighbor_colors(solution, vertex, buffers);
     }
     return false;
 }
 
-bool M_6(Solution &solution, const long turn, std::vector<long> &tabu_list) {
+bool M_6(Solution &solution,
+         const long turn,
+         std::vector<long> &tabu_list,
+         PartialTSBuffers &buffers) {
     // M6 : pick a random uncolored vertex and try to relocate its neighbors
     const int vertex = rd::choice(solution.uncolored());
 
-    std::vector<int> relocated(solution.nb_colors(), 0);
-    std::vector<int> costs(solution.nb_colors(), 0);
+    auto &relocated = buffers.relocated;
+    auto &costs = buffers.costs;
 
-    std::vector<int> best_grenade;
+    auto &best_grenade = buffers.best_grenade;
+    best_grenade.clear();
     int min_cost = graph->nb_vertices;
 
     for (const auto &neighbor : graph->neighborhood[vertex]) {
         const int c_neighbor = solution[neighbor];
         if (c_neighbor == -1)
             continue;
-        if (not solution.possible_colors(neighbor).empty()) {
+        if (solution.nb_free_colors(neighbor) > 0) {
             ++relocated[c_neighbor];
         } else {
             ++relocated[c_neighbor];
@@ -512,13 +783,14 @@ bool M_6(Solution &solution, const long turn, std::vector<long> &tabu_list) {
 
         best_grenade.emplace_back(c_neighbor);
     }
+    reset_neighbor_colors(solution, vertex, buffers);
 
     if (best_grenade.empty()) {
         return false;
     }
 
     std::fill(tabu_list.begin(), tabu_list.end(), 0);
-    solution.grenade_move_optimized(vertex, rd::choice(best_grenade));
+    grenade(solution, vertex, rd::choice(best_grenade), buffers);
     tabu_list[vertex] = turn + static_cast<long>(solution.nb_colors());
     // fmt::print("M6 : vertex {} to color {}\n", vertex, solution[vertex]);
     return true;
@@ -551,13 +823,15 @@ std::optional<Solution> partial_ts(Solution &best_solution, const ParamLS &param
     Solution solution = best_solution;
 
     long turn = 0;
+    Stagnation stagnation(param, best_solution);
 
-    std::vector<int> vertices;
-    vertices.resize(graph->nb_vertices);
-    std::iota(vertices.begin(), vertices.end(), 0);
+    PartialTSBuffers buffers;
+    buffers.max_cascade_depth = param.max_cascade_depth;
+    buffers.vertices.resize(graph->nb_vertices);
+    std::iota(buffers.vertices.begin(), buffers.vertices.end(), 0);
 
-    while (not parameters->time_limit_reached_sub_method(max_time) and
-           turn < param.max_iterations and
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
            not(best_solution.is_legal() and
                best_solution.nb_colors() == parameters->nb_colors)) {
 
@@ -575,32 +849,28 @@ std::optional<Solution> partial_ts(Solution &best_solution, const ParamLS &param
         int best_found = solution.nb_uncolored();
         std::vector<long> tabu_list(graph->nb_vertices, 0);
 
-        std::uniform_int_distribution<int> distribution_colors(0,
-                                                               solution.nb_colors() - 1);
-
-        // vector of colors from 0 to nb_colors -1
-        std::vector<int> colors(solution.nb_colors());
-        std::iota(colors.begin(), colors.end(), 0);
+        buffers.relocated.assign(solution.nb_colors(), 0);
+        buffers.costs.assign(solution.nb_colors(), 0);
 
         turn = 0;
-        while (not parameters->time_limit_reached_sub_method(max_time) and
-               turn < param.max_iterations and not best_solution.is_legal()) {
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
 
             ++turn;
             bool change = false;
-            std::shuffle(vertices.begin(), vertices.end(), rd::generator);
-            std::shuffle(colors.begin(), colors.end(), rd::generator);
 
-            if (M_1_2_3(solution, turn, tabu_list)) {
+            if (M_1_2_3(solution, turn, tabu_list, buffers)) {
                 change = true;
                 assert(solution.check_solution());
-            } else if (M_4(solution, turn, tabu_list, vertices)) {
+            } else if (M_4(solution, turn, tabu_list, buffers)) {
                 change = true;
                 assert(solution.check_solution());
-            } else if (M_5(solution, turn, tabu_list, vertices)) {
+            } else if (M_5(solution, turn, tabu_list, buffers)) {
                 change = true;
                 assert(solution.check_solution());
-            } else if (M_6(solution, turn, tabu_list)) {
+            } else if (M_6(solution, turn, tabu_list, buffers)) {
                 change = true;
                 assert(solution.check_solution());
             }
@@ -609,12 +879,15 @@ std::optional<Solution> partial_ts(Solution &best_solution, const ParamLS &param
             }
             assert(solution.check_solution());
 
+            try_finisher(solution, best_found, param);
+
             if (solution.nb_uncolored() < best_found) {
                 best_found = solution.nb_uncolored();
                 best_solution = solution;
                 best_time =
                     parameters->elapsed_time(std::chrono::high_resolution_clock::now());
                 best_turn = turn;
+                stagnation.improvement(turn);
                 if (param.verbose) {
                     print_result_ls(best_time, best_solution, turn);
                 }
@@ -622,11 +895,17 @@ std::optional<Solution> partial_ts(Solution &best_solution, const ParamLS &param
         }
         if (solution.is_legal()) {
             best_legal_solution = solution;
+            legal_solution_found(param);
             best_legal_time = best_time;
             best_legal_turn = best_turn;
         }
     }
     if (param.verbose) {
+        fmt::print(parameters->output,
+                   "#grenade cascades : {} moves, {} moved vertices, longest {}\n",
+                   buffers.nb_cascades,
+                   buffers.total_cascade_length,
+                   buffers.max_cascade_length);
         print_result_ls(best_time, best_solution, best_turn);
         if (best_legal_solution) {
             print_result_ls(best_legal_time, best_legal_solution, best_legal_turn);
@@ -639,7 +918,53 @@ std::optional<Solution> partial_ts(Solution &best_solution, const ParamLS &param
     return best_legal_solution;
 }
 
-std::optional<Solution> tabu_col(Solution &best_solution, const ParamLS &param) {
+/**
+ * @brief Try to free a color for the uncolored vertex with a Kempe chain: for each color
+ * with only one neighbor, the chain of this neighbor with a random other color frees the
+ * color if it contains no neighbors of the vertex with the other color
+ *
+ * @return int freed color or -1 if no chain frees a color
+ */
+int kempe_free_color(Solution &solution, const int vertex) {
+    const int nb_colors = solution.nb_colors();
+    // a chain needs a second color
+    if (nb_colors < 2) {
+        return -1;
+    }
+    std::uniform_int_distribution<int> distribution_colors(0, nb_colors - 2);
+    for (int color = 0; color < nb_colors; ++color) {
+        if (solution.nb_conflicts(vertex, color) != 1) {
+            continue;
+        }
+        int neighbor_color = -1;
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            if (solution[neighbor] == color) {
+                neighbor_color = neighbor;
+                break;
+            }
+        }
+        // one chain with a random other color for each candidate color
+        int other_color = distribution_colors(rd::generator);
+        if (other_color >= color) {
+            ++other_color;
+        }
+        solution.kempe_chain(neighbor_color, other_color);
+        bool frees_color = true;
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            if (solution[neighbor] == other_color and solution.in_kempe_chain(neighbor)) {
+                frees_color = false;
+                break;
+            }
+        }
+        if (frees_color) {
+            solution.apply_kempe_chain();
+            return color;
+        }
+    }
+    return -1;
+}
+
+std::optional<Solution> kempe_col(Solution &best_solution, const ParamLS &param) {
     const auto max_time =
         std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
 
@@ -655,29 +980,28 @@ std::optional<Solution> tabu_col(Solution &best_solution, const ParamLS &param)
     std::uniform_int_distribution<long> distribution_tabu(param.random_min,
                                                           param.random_max);
 
-    if (best_solution.nb_uncolored() != 0) {
-        best_solution.color_uncolored();
+    if (best_solution.penalty() != 0) {
+        best_solution.remove_penalty();
     }
 
     if (parameters->use_target and best_solution.nb_colors() > parameters->nb_colors) {
         // remove all excess colors
-        best_solution = best_solution.reduce_nb_colors_illegal(parameters->nb_colors);
+        best_solution =
+            best_solution.reduce_nb_colors_partial_legal(parameters->nb_colors);
         assert(best_solution.check_solution());
     }
 
     Solution solution = best_solution;
-
     long turn = 0;
+    Stagnation stagnation(param, best_solution);
 
-    while (not parameters->time_limit_reached_sub_method(max_time) and
-           turn < param.max_iterations and
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
            not(best_solution.is_legal() and
                best_solution.nb_colors() == parameters->nb_colors)) {
 
         if (solution.is_legal() and not parameters->use_target) {
-            // remove one color
-            solution = solution.reduce_nb_colors_illegal(solution.nb_colors() - 1);
-
+            solution = solution.reduce_nb_colors_partial_legal(solution.nb_colors() - 1);
             best_solution = solution;
             if (param.verbose) {
                 print_result_ls(best_time, best_solution, turn);
@@ -685,68 +1009,79 @@ std::optional<Solution> tabu_col(Solution &best_solution, const ParamLS &param)
             assert(solution.check_solution());
         }
 
-        solution.init_deltas();
-
-        int best_found = solution.penalty();
+        int best_found = solution.nb_uncolored();
         std::vector<std::vector<long>> tabu_matrix(
             graph->nb_vertices, std::vector<long>(solution.nb_colors(), 0));
+        std::uniform_int_distribution<int> distribution_colors(0,
+                                                               solution.nb_colors() - 1);
 
         turn = 0;
-        while (not parameters->time_limit_reached_sub_method(max_time) and
-               turn < param.max_iterations and not best_solution.is_legal()) {
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
 
             ++turn;
 
             int best_current = std::numeric_limits<int>::max();
             std::vector<Coloration> best_colorations;
 
-            for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
-                if (solution.nb_conflicts(vertex) == 0) {
-                    continue;
-                }
+            for (const int vertex : solution.uncolored()) {
                 for (int color = 0; color < solution.nb_colors(); ++color) {
-                    if (color == solution[vertex]) {
-                        continue;
-                    }
-                    const int delta_conflict =
-                        solution.delta_conflicts_colors(vertex, color);
-                    if (delta_conflict > best_current) {
+                    const int nb_conflicts = solution.nb_conflicts(vertex, color);
+                    if (nb_conflicts > best_current) {
                         continue;
                     }
                     const bool is_move_tabu = tabu_matrix[vertex][color] >= turn;
                     const bool is_improving =
-                        solution.penalty() + delta_conflict < best_found;
+                        nb_conflicts == 0 and solution.nb_uncolored() <= best_found;
                     if (is_move_tabu and not is_improving) {
                         continue;
                     }
-                    if (delta_conflict < best_current) {
-                        best_current = delta_conflict;
+
+                    if (nb_conflicts < best_current) {
+                        best_current = nb_conflicts;
                         best_colorations.clear();
                     }
                     best_colorations.emplace_back(Coloration{vertex, color});
                 }
             }
+            // If no move, pick a random one
             if (best_colorations.empty()) {
-                continue;
+                const int vertex = rd::choice(solution.uncolored());
+                const int color = distribution_colors(rd::generator);
+                best_colorations.emplace_back(Coloration{vertex, color});
             }
 
             const auto [vertex, color] = rd::choice(best_colorations);
-            const int old_color = solution.move_to_color(vertex, color);
 
-            tabu_matrix[vertex][old_color] =
-                turn + distribution_tabu(rd::generator) +
-                static_cast<long>(
-                    static_cast<double>(solution.conflicting_vertices().size()) *
-                    param.alpha);
+            // Without a free color, try to free one with a Kempe chain interchange
+            const int kempe_color =
+                best_current == 0 ? -1 : kempe_free_color(solution, vertex);
+            if (kempe_color != -1) {
+                solution.add_to_color(vertex, kempe_color);
+            } else {
+                solution.grenade_move(vertex, color);
+
+                // Block neighbor of the best move from coming to the color
+                for (const int neighbor : graph->neighborhood[vertex]) {
+                    long t_tenure =
+                        static_cast<long>(param.alpha *
+                                          static_cast<double>(solution.nb_uncolored())) +
+                        distribution_tabu(rd::generator);
+                    tabu_matrix[neighbor][color] = turn + t_tenure;
+                }
+            }
 
             assert(solution.check_solution());
 
-            if (solution.penalty() < best_found) {
-                best_found = solution.penalty();
+            if (solution.nb_uncolored() < best_found) {
+                best_found = solution.nb_uncolored();
                 best_solution = solution;
                 best_time =
                     parameters->elapsed_time(std::chrono::high_resolution_clock::now());
                 best_turn = turn;
+                stagnation.improvement(turn);
                 if (param.verbose) {
                     print_result_ls(best_time, best_solution, turn);
                 }
@@ -754,6 +1089,7 @@ std::optional<Solution> tabu_col(Solution &best_solution, const ParamLS &param)
         }
         if (solution.is_legal()) {
             best_legal_solution = solution;
+            legal_solution_found(param);
             best_legal_time = best_time;
             best_legal_turn = best_turn;
         }
@@ -764,12 +1100,82 @@ std::optional<Solution> tabu_col(Solution &best_solution, const ParamLS &param)
             print_result_ls(best_legal_time, best_legal_solution, best_legal_turn);
         }
     }
+    if (best_solution.nb_uncolored() != 0) {
+        best_solution.color_uncolored();
+    }
     assert(best_solution.check_solution());
     return best_legal_solution;
 }
 
-std::optional<Solution> tabu_col_optimized(Solution &best_solution,
-                                           const ParamLS &param) {
+/**
+ * @brief Buffers of the threads scanning the neighborhood, kept between the iterations
+ */
+struct ScanBuffers {
+    /** @brief for each thread, its best moves*/
+    std::vector<std::vector<Coloration>> colorations{};
+    /** @brief for each thread, the delta of its best moves*/
+    std::vector<int> best{};
+};
+
+/**
+ * @brief Scan the vertices to find the best moves, split the scan between param.scan_threads
+ * threads when there is at least param.scan_min_vertices vertices to scan.
+ *
+ * Each thread scans a contiguous chunk of the vertices and keeps its own best moves, the
+ * lists of the threads having the best delta are then concatenated in the order of the
+ * chunks so best_colorations is the same as the one of a sequential scan and the
+ * selected move only depends on the random generator.
+ *
+ * scan_vertex(vertex, best_delta, best_colorations) must add the moves of the vertex not
+ * worse than best_delta to best_colorations (clearing it when best_delta is improved)
+ * and must not modify anything else.
+ */
+template <typename ScanVertex>
+void scan_best_moves(const std::vector<int> &vertices,
+                     const ParamLS &param,
+                     ScanBuffers &buffers,
+                     std::vector<Coloration> &best_colorations,
+                     const ScanVertex &scan_vertex) {
+    best_colorations.clear();
+    const int nb_vertices = static_cast<int>(vertices.size());
+    if (param.scan_threads <= 1 or nb_vertices < param.scan_min_vertices) {
+        int best_delta = std::numeric_limits<int>::max();
+        for (const auto vertex : vertices) {
+            scan_vertex(vertex, best_delta, best_colorations);
+        }
+        return;
+    }
+
+    const int nb_threads = param.scan_threads;
+    buffers.colorations.resize(nb_threads);
+    buffers.best.assign(nb_threads, std::numeric_limits<int>::max());
+#pragma omp parallel num_threads(nb_threads)
+    {
+        // the team can be smaller than requested (nested parallelism)
+        const int thread = omp_get_thread_num();
+        const int team_size = omp_get_num_threads();
+        const int begin = nb_vertices * thread / team_size;
+        const int end = nb_vertices * (thread + 1) / team_size;
+        auto &colorations = buffers.colorations[thread];
+        colorations.clear();
+        int best_delta = std::numeric_limits<int>::max();
+        for (int i = begin; i < end; ++i) {
+            scan_vertex(vertices[i], best_delta, colorations);
+        }
+        buffers.best[thread] = best_delta;
+    }
+
+    const int best_delta = *std::min_element(buffers.best.begin(), buffers.best.end());
+    for (int thread = 0; thread < nb_threads; ++thread) {
+        if (buffers.best[thread] == best_delta) {
+            best_colorations.insert(best_colorations.end(),
+                                    buffers.colorations[thread].begin(),
+                                    buffers.colorations[thread].end());
+        }
+    }
+}
+
+std::optional<Solution> tabu_col(Solution &best_solution, const ParamLS &param) {
     const auto max_time =
         std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
 
@@ -784,6 +1190,7 @@ std::optional<Solution> tabu_col_optimized(Solution &best_solution,
 
     std::uniform_int_distribution<long> distribution_tabu(param.random_min,
                                                           param.random_max);
+
     if (best_solution.nb_uncolored() != 0) {
         best_solution.color_uncolored();
     }
@@ -791,115 +1198,88 @@ std::optional<Solution> tabu_col_optimized(Solution &best_solution,
     if (parameters->use_target and best_solution.nb_colors() > parameters->nb_colors) {
         // remove all excess colors
         best_solution = best_solution.reduce_nb_colors_illegal(parameters->nb_colors);
+        assert(best_solution.check_solution());
     }
 
     Solution solution = best_solution;
 
     long turn = 0;
+    Stagnation stagnation(param, best_solution);
 
-    while (not parameters->time_limit_reached_sub_method(max_time) and
-           turn < param.max_iterations and
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
            not(best_solution.is_legal() and
                best_solution.nb_colors() == parameters->nb_colors)) {
 
         if (solution.is_legal() and not parameters->use_target) {
             // remove one color
             solution = solution.reduce_nb_colors_illegal(solution.nb_colors() - 1);
+
             best_solution = solution;
             if (param.verbose) {
                 print_result_ls(best_time, best_solution, turn);
             }
             assert(solution.check_solution());
         }
-        solution.init_deltas_optimized();
+
+        solution.init_deltas();
 
         int best_found = solution.penalty();
         std::vector<std::vector<long>> tabu_matrix(
             graph->nb_vertices, std::vector<long>(solution.nb_colors(), 0));
 
-        turn = 0;
-
-        while (not parameters->time_limit_reached_sub_method(max_time) and
-               turn < param.max_iterations and not best_solution.is_legal()) {
-
-            ++turn;
-
-            int best_nb_conflicts = std::numeric_limits<int>::max();
-            std::vector<Coloration> best_colorations;
-
-            for (const auto vertex : solution.conflicting_vertices()) {
-                const int current_best_improve = solution.best_delta(vertex);
-                if (current_best_improve > best_nb_conflicts) {
+        const auto scan_vertex = [&](const int vertex,
+                                     int &best_current,
+                                     std::vector<Coloration> &colorations) {
+            for (int color = 0; color < solution.nb_colors(); ++color) {
+                if (color == solution[vertex]) {
                     continue;
                 }
-
-                const int current_color = solution[vertex];
-                bool added = false;
-
-                for (const auto &color : solution.best_improve_colors(vertex)) {
-                    if (color == current_color) {
-                        continue;
-                    }
-
-                    const bool vertex_tabu = (tabu_matrix[vertex][color] >= turn);
-                    const bool improve_best_solution =
-                        (((current_best_improve + solution.penalty()) < best_found));
-
-                    if (not improve_best_solution and vertex_tabu) {
-                        continue;
-                    }
-
-                    added = true;
-                    if (current_best_improve < best_nb_conflicts) {
-                        best_nb_conflicts = current_best_improve;
-                        best_colorations.clear();
-                    }
-                    best_colorations.emplace_back(Coloration{vertex, color});
+                const int delta_conflict = solution.delta_conflicts_colors(vertex, color);
+                if (delta_conflict > best_current) {
+                    continue;
                 }
-
-                if (added or (current_best_improve >= best_nb_conflicts)) {
+                const bool is_move_tabu = tabu_matrix[vertex][color] >= turn;
+                const bool is_improving = solution.penalty() + delta_conflict < best_found;
+                if (is_move_tabu and not is_improving) {
                     continue;
                 }
+                if (delta_conflict < best_current) {
+                    best_current = delta_conflict;
+                    colorations.clear();
+                }
+                colorations.emplace_back(Coloration{vertex, color});
+            }
+        };
+        ScanBuffers scan_buffers;
+        std::vector<Coloration> best_colorations;
 
-                // if the bests moves are tabu we have to look for other moves
-                for (int color = 0; color < solution.nb_colors(); color++) {
-                    if (color == current_color) {
-                        continue;
-                    }
-
-                    const int conflicts = solution.delta_conflicts_colors(vertex, color);
-                    if (conflicts > best_nb_conflicts) {
-                        continue;
-                    }
+        turn = 0;
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
 
-                    const bool vertex_tabu = (tabu_matrix[vertex][color] >= turn);
-                    const bool improve_best_solution =
-                        (((current_best_improve + solution.penalty()) < best_found));
-                    if (not improve_best_solution and vertex_tabu) {
-                        continue;
-                    }
+            ++turn;
 
-                    if ((conflicts < best_nb_conflicts)) {
-                        best_nb_conflicts = conflicts;
-                        best_colorations.clear();
-                    }
-                    best_colorations.emplace_back(Coloration{vertex, color});
-                }
-            }
+            // only the vertices in conflicts, in increasing order
+            scan_best_moves(solution.conflicting_vertices(),
+                            param,
+                            scan_buffers,
+                            best_colorations,
+                            scan_vertex);
             if (best_colorations.empty()) {
                 continue;
             }
 
-            // select and apply the best move
             const auto [vertex, color] = rd::choice(best_colorations);
-            const int old_color = solution.move_to_color_optimized(vertex, color);
+            const int old_color = solution.move_to_color(vertex, color);
 
-            // update tabu matrix
             tabu_matrix[vertex][old_color] =
                 turn + distribution_tabu(rd::generator) +
                 static_cast<long>(
-                    param.alpha *
-                    static_cast<double>(solution.conflicting_vertices().size()));
+                    static_cast<double>(solution.conflicting_vertices().size()) *
+                    param.alpha);
 
             assert(solution.check_solution());
 
@@ -909,6 +1289,7 @@ std::optional<Solution> tabu_col_optimized(Solution &best_solution,
                 best_time =
                     parameters->elapsed_time(std::chrono::high_resolution_clock::now());
                 best_turn = turn;
+                stagnation.improvement(turn);
                 if (param.verbose) {
                     print_result_ls(best_time, best_solution, turn);
                 }
@@ -916,6 +1297,7 @@ std::optional<Solution> tabu_col_optimized(Solution &best_solution,
         }
         if (solution.is_legal()) {
             best_legal_solution = solution;
+            legal_solution_found(param);
             best_legal_time = best_time;
             best_legal_turn = best_turn;
         }
@@ -930,60 +1312,486 @@ std::optional<Solution> tabu_col_optimized(Solution &best_solution,
     return best_legal_solution;
 }
 
-bool check_solution(const std::vector<bool> &_solution,
-                    const int _score_UBQP,
-                    const int _penalty,
-                    const std::vector<int> &_delta_scores,
-                    std::map<int, std::vector<int>> _buckets) {
-    (void)_score_UBQP;   // only used in assert
-    (void)_penalty;      // only used in assert
-    (void)_delta_scores; // only used in assert
-    (void)_buckets;      // only used in assert
+std::optional<Solution> tabu_edge(Solution &best_solution, const ParamLS &param) {
+    const auto max_time =
+        std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
 
-    int score_UBQP = 0;
-    // compute score
-    for (int arc1 = 0; arc1 < qgraph->nb_arc; ++arc1) {
-        for (int arc2 = 0; arc2 <= arc1; ++arc2) {
-            score_UBQP += qgraph->qmatrix[arc1][arc2] * _solution[arc1] * _solution[arc2];
-        }
+    int64_t best_time = 0;
+    int64_t best_turn = 0;
+    int64_t best_legal_time = 0;
+    int64_t best_legal_turn = 0;
+    std::optional<Solution> best_legal_solution = std::nullopt;
+    if (best_solution.is_legal()) {
+        best_legal_solution = best_solution;
     }
-    assert(score_UBQP == _score_UBQP);
 
-    std::vector<int> delta_scores(qgraph->nb_arc, 0);
-    int penalty = 0;
+    std::uniform_int_distribution<long> distribution_tabu(param.random_min,
+                                                          param.random_max);
 
-    // init delta score
-    for (int arc = 0; arc < qgraph->nb_arc; ++arc) {
-        delta_scores[arc] = qgraph->qmatrix[arc][arc];
-        for (const auto neighbor : qgraph->neighborhood[arc]) {
-            delta_scores[arc] += qgraph->qmatrix[arc][neighbor] * _solution[neighbor];
-            if (_solution[arc] and _solution[neighbor]) {
-                ++penalty;
-            }
-        }
-        if (_solution[arc] == 1) {
-            delta_scores[arc] = -delta_scores[arc];
-        }
+    if (best_solution.nb_uncolored() != 0) {
+        best_solution.color_uncolored();
     }
-    assert(delta_scores == _delta_scores);
-
-    penalty /= 2;
-    assert(penalty == _penalty);
-
-    std::map<int, std::vector<int>> buckets;
 
-    // init buckets
-    for (int arc = 0; arc < qgraph->nb_arc; ++arc) {
-        insert_sorted(buckets[delta_scores[arc]], arc);
+    if (parameters->use_target and best_solution.nb_colors() > parameters->nb_colors) {
+        // remove all excess colors
+        best_solution = best_solution.reduce_nb_colors_illegal(parameters->nb_colors);
+        assert(best_solution.check_solution());
     }
 
-    for (const auto &[delta, arcs] : buckets) {
-        (void)delta;
-        (void)arcs;
-        assert(arcs == _buckets.at(delta));
-    }
+    Solution solution = best_solution;
 
-    return true;
+    long turn = 0;
+    Stagnation stagnation(param, best_solution);
+
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
+           not(best_solution.is_legal() and
+               best_solution.nb_colors() == parameters->nb_colors)) {
+
+        if (solution.is_legal() and not parameters->use_target) {
+            // remove one color
+            solution = solution.reduce_nb_colors_illegal(solution.nb_colors() - 1);
+
+            best_solution = solution;
+            if (param.verbose) {
+                print_result_ls(best_time, best_solution, turn);
+            }
+            assert(solution.check_solution());
+        }
+
+        solution.init_edge_weights();
+        int nb_increases = 0;
+
+        int best_found = solution.penalty();
+        std::vector<std::vector<long>> tabu_matrix(
+            graph->nb_vertices, std::vector<long>(solution.nb_colors(), 0));
+
+        const auto scan_vertex = [&](const int vertex,
+                                     int &best_current,
+                                     std::vector<Coloration> &colorations) {
+            for (int color = 0; color < solution.nb_colors(); ++color) {
+                if (color == solution[vertex]) {
+                    continue;
+                }
+                const int delta_weight = solution.weighted_delta(vertex, color);
+                if (delta_weight > best_current) {
+                    continue;
+                }
+                const bool is_move_tabu = tabu_matrix[vertex][color] >= turn;
+                const int delta_conflict = solution.nb_conflicts(vertex, color) -
+                                           solution.nb_conflicts(vertex);
+                const bool is_improving = solution.penalty() + delta_conflict < best_found;
+                if (is_move_tabu and not is_improving) {
+                    continue;
+                }
+                if (delta_weight < best_current) {
+                    best_current = delta_weight;
+                    colorations.clear();
+                }
+                colorations.emplace_back(Coloration{vertex, color});
+            }
+        };
+        ScanBuffers scan_buffers;
+        std::vector<Coloration> best_colorations;
+
+        turn = 0;
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
+
+            ++turn;
+
+            // only the vertices in conflicts, in increasing order
+            scan_best_moves(solution.conflicting_vertices(),
+                            param,
+                            scan_buffers,
+                            best_colorations,
+                            scan_vertex);
+            if (best_colorations.empty()) {
+                continue;
+            }
+
+            const auto [vertex, color] = rd::choice(best_colorations);
+            if (solution.weighted_delta(vertex, color) > 0) {
+                // local minimum of the weighted penalty, increase the weights instead
+                solution.increase_edge_weights();
+                ++nb_increases;
+                if (param.edge_smoothing > 0 and
+                    nb_increases % param.edge_smoothing == 0) {
+                    solution.smooth_edge_weights();
+                }
+                assert(solution.check_edge_weights());
+                continue;
+            }
+            const int old_color = solution.move_to_color_edge(vertex, color);
+
+            tabu_matrix[vertex][old_color] =
+                turn + distribution_tabu(rd::generator) +
+                static_cast<long>(
+                    static_cast<double>(solution.conflicting_vertices().size()) *
+                    param.alpha);
+
+            assert(solution.check_solution());
+            assert(solution.check_edge_weights());
+
+            if (solution.penalty() < best_found) {
+                best_found = solution.penalty();
+                best_solution = solution;
+                best_time =
+                    parameters->elapsed_time(std::chrono::high_resolution_clock::now());
+                best_turn = turn;
+                stagnation.improvement(turn);
+                if (param.verbose) {
+                    print_result_ls(best_time, best_solution, turn);
+                }
+            }
+        }
+        if (solution.is_legal()) {
+            best_legal_solution = solution;
+            legal_solution_found(param);
+            best_legal_time = best_time;
+            best_legal_turn = best_turn;
+        }
+    }
+    if (param.verbose) {
+        print_result_ls(best_time, best_solution, best_turn);
+        if (best_legal_solution) {
+            print_result_ls(best_legal_time, best_legal_solution, best_legal_turn);
+        }
+    }
+    assert(best_solution.check_solution());
+    return best_legal_solution;
+}
+
+std::optional<Solution> tabu_col_optimized(Solution &best_solution,
+                                           const ParamLS &param) {
+    const auto max_time =
+        std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
+
+    int64_t best_time = 0;
+    int64_t best_turn = 0;
+    int64_t best_legal_time = 0;
+    int64_t best_legal_turn = 0;
+    std::optional<Solution> best_legal_solution = std::nullopt;
+    if (best_solution.is_legal()) {
+        best_legal_solution = best_solution;
+    }
+
+    std::uniform_int_distribution<long> distribution_tabu(param.random_min,
+                                                          param.random_max);
+    if (best_solution.nb_uncolored() != 0) {
+        best_solution.color_uncolored();
+    }
+
+    if (parameters->use_target and best_solution.nb_colors() > parameters->nb_colors) {
+        // remove all excess colors
+        best_solution = best_solution.reduce_nb_colors_illegal(parameters->nb_colors);
+    }
+
+    Solution solution = best_solution;
+
+    long turn = 0;
+    Stagnation stagnation(param, best_solution);
+
+    std::optional<ReactiveTabu> reactive = std::nullopt;
+    if (param.reactive) {
+        reactive.emplace(param.reactive.value());
+    }
+
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
+           not(best_solution.is_legal() and
+               best_solution.nb_colors() == parameters->nb_colors)) {
+
+        if (solution.is_legal() and not parameters->use_target) {
+            // remove one color
+            solution = solution.reduce_nb_colors_illegal(solution.nb_colors() - 1);
+            best_solution = solution;
+            if (param.verbose) {
+                print_result_ls(best_time, best_solution, turn);
+            }
+            assert(solution.check_solution());
+        }
+        // the deltas are kept when resuming from a perturbed solution (ILS)
+        if (not solution.deltas_up_to_date()) {
+            solution.init_deltas_optimized();
+        }
+        if (reactive) {
+            reactive->reset(solution);
+        }
+
+        int best_found = solution.penalty();
+        std::vector<std::vector<long>> tabu_matrix(
+            graph->nb_vertices, std::vector<long>(solution.nb_colors(), 0));
+
+        const auto scan_vertex = [&](const int vertex,
+                                     int &best_nb_conflicts,
+                                     std::vector<Coloration> &colorations) {
+            const int current_best_improve = solution.best_delta(vertex);
+            if (current_best_improve > best_nb_conflicts) {
+                return;
+            }
+
+            const int current_color = solution[vertex];
+            bool added = false;
+
+            for (const auto &color : solution.best_improve_colors(vertex)) {
+                if (color == current_color) {
+                    continue;
+                }
+
+                const bool vertex_tabu = (tabu_matrix[vertex][color] >= turn);
+                const bool improve_best_solution =
+                    (((current_best_improve + solution.penalty()) < best_found));
+
+                if (not improve_best_solution and vertex_tabu) {
+                    continue;
+                }
+
+                added = true;
+                if (current_best_improve < best_nb_conflicts) {
+                    best_nb_conflicts = current_best_improve;
+                    colorations.clear();
+                }
+                colorations.emplace_back(Coloration{vertex, color});
+            }
+
+            if (added or (current_best_improve >= best_nb_conflicts)) {
+                return;
+            }
+
+            // if the bests moves are tabu we have to look for other moves
+            for (int color = 0; color < solution.nb_colors(); color++) {
+                if (color == current_color) {
+                    continue;
+                }
+
+                const int conflicts = solution.delta_conflicts_colors(vertex, color);
+                if (conflicts > best_nb_conflicts) {
+                    continue;
+                }
+
+                const bool vertex_tabu = (tabu_matrix[vertex][color] >= turn);
+                const bool improve_best_solution =
+                    (((current_best_improve + solution.penalty()) < best_found));
+                if (not improve_best_solution and vertex_tabu) {
+                    continue;
+                }
+
+                if ((conflicts < best_nb_conflicts)) {
+                    best_nb_conflicts = conflicts;
+                    colorations.clear();
+                }
+                colorations.emplace_back(Coloration{vertex, color});
+            }
+        };
+        ScanBuffers scan_buffers;
+        std::vector<Coloration> best_colorations;
+        std::vector<int> sample;
+
+        turn = 0;
+        stagnation.reset();
+
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
+
+            ++turn;
+
+            // only a sample of the vertices in conflicts with param.sampling
+            scan_best_moves(
+                sample_vertices(solution.conflicting_vertices(), param, sample),
+                param,
+                scan_buffers,
+                best_colorations,
+                scan_vertex);
+            if (best_colorations.empty()) {
+                continue;
+            }
+
+            // select and apply the best move
+            const auto [vertex, color] = rd::choice(best_colorations);
+            const int old_color = solution.move_to_color_optimized(vertex, color);
+
+            // update tabu matrix
+            const auto nb_conflicting =
+                static_cast<double>(solution.conflicting_vertices().size());
+            long tenure = distribution_tabu(rd::generator) +
+                          static_cast<long>(param.alpha * nb_conflicting);
+            if (reactive) {
+                reactive->move(vertex, old_color, color);
+                tenure = reactive->tenure(tenure);
+            }
+            tabu_matrix[vertex][old_color] = turn + tenure;
+
+            // escape from the cycle with random moves of conflicting vertices
+            if (reactive and reactive->visit(turn)) {
+                for (int i = 0; i < param.reactive->escape_moves; ++i) {
+                    // with one color, a vertex has no other color to escape to
+                    if (solution.conflicting_vertices().empty() or
+                        solution.nb_colors() < 2) {
+                        break;
+                    }
+                    const int escape_vertex = rd::choice(solution.conflicting_vertices());
+                    const int escape_old_color = solution[escape_vertex];
+                    std::uniform_int_distribution<int> distribution_escape(
+                        0, solution.nb_colors() - 2);
+                    int escape_color = distribution_escape(rd::generator);
+                    if (escape_color >= escape_old_color) {
+                        ++escape_color;
+                    }
+                    solution.move_to_color_optimized(escape_vertex, escape_color);
+                    reactive->move(escape_vertex, escape_old_color, escape_color);
+                }
+                reactive->reset(solution);
+            }
+
+            assert(solution.check_solution());
+            assert(not reactive or reactive->check_hash(solution));
+
+            if (solution.penalty() < best_found) {
+                best_found = solution.penalty();
+                best_solution = solution;
+                best_time =
+                    parameters->elapsed_time(std::chrono::high_resolution_clock::now());
+                best_turn = turn;
+                stagnation.improvement(turn);
+                if (param.verbose) {
+                    print_result_ls(best_time, best_solution, turn);
+                }
+            }
+        }
+        if (solution.is_legal()) {
+            best_legal_solution = solution;
+            legal_solution_found(param);
+            best_legal_time = best_time;
+            best_legal_turn = best_turn;
+        }
+    }
+    if (param.verbose) {
+        print_result_ls(best_time, best_solution, best_turn);
+        if (best_legal_solution) {
+            print_result_ls(best_legal_time, best_legal_solution, best_legal_turn);
+        }
+    }
+    assert(best_solution.check_solution());
+    return best_legal_solution;
+}
+
+/**
+ * @brief Buckets of arcs indexed by their delta score for tabu bucket
+ *
+ * The deltas are in [-offset, offset], bucket i holds the arcs of delta i - offset in no
+ * particular order, the position of each arc in its bucket is kept so an arc is moved from
+ * one bucket to another in O(1)
+ */
+struct DeltaBuckets {
+    /** @brief bound of the absolute value of the deltas*/
+    const int offset;
+    /** @brief for each delta + offset, set of arcs with this delta (unsorted)*/
+    std::vector<std::vector<int>> buckets;
+    /** @brief for each arc, its position in its bucket*/
+    std::vector<int> positions;
+    /** @brief buckets before this one are empty*/
+    int min_bucket;
+
+    explicit DeltaBuckets(const std::vector<int> &delta_scores, const int max_degree)
+        : offset(1 + 2 * max_degree),
+          buckets(static_cast<size_t>(2 * offset + 1)),
+          positions(delta_scores.size(), -1),
+          min_bucket(2 * offset + 1) {
+        for (int arc = 0; arc < static_cast<int>(delta_scores.size()); ++arc) {
+            insert(arc, delta_scores[arc]);
+        }
+    }
+
+    void insert(const int arc, const int delta) {
+        const int index = delta + offset;
+        assert(index >= 0 and index < static_cast<int>(buckets.size()));
+        auto &bucket = buckets[index];
+        positions[arc] = static_cast<int>(bucket.size());
+        bucket.emplace_back(arc);
+        min_bucket = std::min(min_bucket, index);
+    }
+
+    void erase(const int arc, const int delta) {
+        const int index = delta + offset;
+        auto &bucket = buckets[index];
+        const int position = positions[arc];
+        const int last_arc = bucket.back();
+        bucket[position] = last_arc;
+        positions[last_arc] = position;
+        bucket.pop_back();
+        positions[arc] = -1;
+        while (min_bucket < static_cast<int>(buckets.size()) and
+               buckets[min_bucket].empty()) {
+            ++min_bucket;
+        }
+    }
+
+    void move(const int arc, const int old_delta, const int new_delta) {
+        erase(arc, old_delta);
+        insert(arc, new_delta);
+    }
+};
+
+bool check_solution(const std::vector<bool> &_solution,
+                    const int _score_UBQP,
+                    const int _penalty,
+                    const std::vector<int> &_delta_scores,
+                    const DeltaBuckets &_buckets) {
+    (void)_score_UBQP;   // only used in assert
+    (void)_penalty;      // only used in assert
+    (void)_delta_scores; // only used in assert
+    (void)_buckets;      // only used in assert
+
+    int score_UBQP = 0;
+    // compute score
+    for (int arc1 = 0; arc1 < qgraph->nb_arc; ++arc1) {
+        for (int arc2 = 0; arc2 <= arc1; ++arc2) {
+            score_UBQP += qgraph->qmatrix[arc1][arc2] * _solution[arc1] * _solution[arc2];
+        }
+    }
+    assert(score_UBQP == _score_UBQP);
+
+    std::vector<int> delta_scores(qgraph->nb_arc, 0);
+    int penalty = 0;
+
+    // init delta score
+    for (int arc = 0; arc < qgraph->nb_arc; ++arc) {
+        delta_scores[arc] = qgraph->qmatrix[arc][arc];
+        for (const auto neighbor : qgraph->neighborhood[arc]) {
+            delta_scores[arc] += qgraph->qmatrix[arc][neighbor] * _solution[neighbor];
+            if (_solution[arc] and _solution[neighbor]) {
+                ++penalty;
+            }
+        }
+        if (_solution[arc] == 1) {
+            delta_scores[arc] = -delta_scores[arc];
+        }
+    }
+    assert(delta_scores == _delta_scores);
+
+    penalty /= 2;
+    assert(penalty == _penalty);
+
+    // each arc in the bucket of its delta, at its position
+    int nb_arcs = 0;
+    for (int index = 0; index < static_cast<int>(_buckets.buckets.size()); ++index) {
+        const auto &bucket = _buckets.buckets[index];
+        assert(index >= _buckets.min_bucket or bucket.empty());
+        for (int position = 0; position < static_cast<int>(bucket.size()); ++position) {
+            const int arc = bucket[position];
+            (void)arc;
+            assert(_buckets.positions[arc] == position);
+            assert(delta_scores[arc] == index - _buckets.offset);
+            ++nb_arcs;
+        }
+    }
+    assert(nb_arcs == qgraph->nb_arc);
+
+    return true;
 }
 
 std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &param) {
@@ -1037,11 +1845,17 @@ std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &para
     //     fmt::print("\n");
     // }
 
-    // compute score
+    // compute score, only the diagonal and the activated neighbors count
     int score = 0;
-    for (int arc1 = 0; arc1 < qgraph->nb_arc; ++arc1) {
-        for (int arc2 = 0; arc2 <= arc1; ++arc2) {
-            score += qgraph->qmatrix[arc1][arc2] * solution[arc1] * solution[arc2];
+    for (int arc = 0; arc < qgraph->nb_arc; ++arc) {
+        if (not solution[arc]) {
+            continue;
+        }
+        score += qgraph->qmatrix[arc][arc];
+        for (const auto neighbor : qgraph->neighborhood[arc]) {
+            if (neighbor < arc and solution[neighbor]) {
+                score += qgraph->qmatrix[arc][neighbor];
+            }
         }
     }
     int best_score = score;
@@ -1065,12 +1879,12 @@ std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &para
     penalty /= 2;
 
     // insert delta of swap of arc into the buckets
-    std::map<int, std::vector<int>> buckets;
-    // std::map<int, std::set<int>> buckets;
-    for (int arc = 0; arc < qgraph->nb_arc; ++arc) {
-        insert_sorted(buckets[delta_scores[arc]], arc);
-        // buckets[delta_scores[arc]].insert(arc);
+    // the deltas are bounded by 1 + 2 * degree
+    size_t max_degree = 0;
+    for (const auto &neighborhood : qgraph->neighborhood) {
+        max_degree = std::max(max_degree, neighborhood.size());
     }
+    DeltaBuckets buckets(delta_scores, static_cast<int>(max_degree));
 
     if (param.verbose) {
         fmt::print(parameters->output,
@@ -1085,55 +1899,37 @@ std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &para
     long min_tabu = static_cast<long>(qgraph->nb_arc * param.alpha);
     long turn = 0;
 
-    while (not parameters->time_limit_reached_sub_method(max_time) and
+    while (not stop_local_search(param, max_time) and
            turn < param.max_iterations and
            (not parameters->use_target or
             (penalty != 0 or (graph->nb_vertices + score != parameters->nb_colors)))) {
         ++turn;
         // std::vector<int> best_arcs;
         int best_arc = -1;
-        for (const auto &[delta, bucket] : buckets) {
+        for (int index = buckets.min_bucket;
+             index < static_cast<int>(buckets.buckets.size());
+             ++index) {
+            const auto &bucket = buckets.buckets[index];
             if (bucket.empty()) {
                 continue;
             }
+            const int delta = index - buckets.offset;
             const int bucket_size = static_cast<int>(bucket.size());
             const bool aspiration_criteria = delta + score < best_score;
 
+            // first non tabu arc starting from a random position
             std::uniform_int_distribution<int> distribution_bucket(0, bucket_size - 1);
-            auto random_position = distribution_bucket(rd::generator);
-            auto it_bucket = bucket.begin();
-            std::advance(it_bucket, random_position);
-            for (int i = random_position; i < bucket_size; ++i) {
-                if (tabu_list[*it_bucket] <= turn or aspiration_criteria) {
-                    best_arc = *it_bucket;
-                    break;
-                }
-                ++it_bucket;
-            }
-            if (best_arc != -1) {
-                break;
-            }
-            it_bucket = bucket.begin();
-            for (int i = 0; i < bucket_size - random_position; ++i) {
-                if (tabu_list[*it_bucket] <= turn or aspiration_criteria) {
-                    best_arc = *it_bucket;
+            const int random_position = distribution_bucket(rd::generator);
+            for (int i = 0; i < bucket_size; ++i) {
+                const int arc = bucket[(random_position + i) % bucket_size];
+                if (tabu_list[arc] <= turn or aspiration_criteria) {
+                    best_arc = arc;
                     break;
                 }
-                ++it_bucket;
             }
             if (best_arc != -1) {
                 break;
             }
-
-            // for (const auto arc : bucket) {
-            //     if (tabu_list[arc] <= turn or aspiration_criteria) {
-            //         best_arcs.emplace_back(arc);
-            //     }
-            // }
-            // if (best_arcs.empty()) {
-            //     continue;
-            // }
-            // break;
         }
         // if (best_arcs.empty()) {
         //     continue;
@@ -1148,10 +1944,7 @@ std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &para
         const int new_delta = -old_delta;
         score += old_delta;
         delta_scores[best_arc] = new_delta;
-        erase_sorted(buckets[old_delta], best_arc);
-        insert_sorted(buckets[new_delta], best_arc);
-        // buckets[old_delta].erase(best_arc);
-        // buckets[new_delta].insert(best_arc);
+        buckets.move(best_arc, old_delta, new_delta);
 
         const bool old_activation = solution[best_arc];
         for (const auto neighbor : qgraph->neighborhood[best_arc]) {
@@ -1169,10 +1962,7 @@ std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &para
                 }
             }
             const int new_delta_n = delta_scores[neighbor];
-            erase_sorted(buckets[old_delta_n], neighbor);
-            insert_sorted(buckets[new_delta_n], neighbor);
-            // buckets[old_delta_n].erase(neighbor);
-            // buckets[new_delta_n].insert(neighbor);
+            buckets.move(neighbor, old_delta_n, new_delta_n);
         }
         solution[best_arc] = not solution[best_arc];
 
@@ -1204,3 +1994,315 @@ std::optional<Solution> tabu_bucket(Solution &best_solution, const ParamLS &para
     }
     return std::nullopt;
 }
+
+/**
+ * @brief Score of a solution for the iterated local search, its number of colors then its
+ * number of conflicts and uncolored vertices
+ */
+std::tuple<int, int> ils_score(const Solution &solution) {
+    return {solution.nb_colors(), solution.penalty() + solution.nb_uncolored()};
+}
+
+void perturbation_random(Solution &solution, const double perturbation) {
+    const bool partial = solution.nb_uncolored() > 0;
+    std::vector<int> vertices =
+        partial ? solution.uncolored() : solution.conflicting_vertices();
+    if (vertices.empty()) {
+        return;
+    }
+    // the conflicting vertices move to another color, there is none with one color
+    if (solution.nb_colors() < 2) {
+        return;
+    }
+    std::uniform_int_distribution<int> distribution_colors(0, solution.nb_colors() - 1);
+    std::uniform_int_distribution<int> distribution_other_colors(
+        0, solution.nb_colors() - 2);
+    const int nb_moves = std::min(
+        static_cast<int>(vertices.size()),
+        static_cast<int>(std::ceil(perturbation * static_cast<double>(vertices.size()))));
+    for (int i = 0; i < nb_moves; ++i) {
+        // the vertices are drawn in random order
+        std::uniform_int_distribution<int> distribution(
+            i, static_cast<int>(vertices.size()) - 1);
+        std::swap(vertices[i], vertices[distribution(rd::generator)]);
+        const int vertex = vertices[i];
+        const int old_color = solution[vertex];
+        if (partial) {
+            const int color = distribution_colors(rd::generator);
+            if (solution.deltas_up_to_date()) {
+                solution.grenade_move_optimized_2(vertex, color);
+            } else {
+                solution.grenade_move(vertex, color);
+            }
+            continue;
+        }
+        // random color other than the current one
+        int color = distribution_other_colors(rd::generator);
+        if (color >= old_color) {
+            ++color;
+        }
+        // the colors emptied by the local search stay empty
+        if (solution.color_size(color) == 0) {
+            continue;
+        }
+        if (solution.deltas_up_to_date()) {
+            solution.move_to_color_optimized(vertex, color);
+        } else if (solution.color_size(old_color) > 1) {
+            solution.delete_from_color(vertex);
+            solution.add_to_color(vertex, color);
+        }
+    }
+}
+
+void perturbation_kempe(Solution &solution, const double perturbation) {
+    const bool partial = solution.nb_uncolored() > 0;
+    const auto &vertices =
+        partial ? solution.uncolored() : solution.conflicting_vertices();
+    if (vertices.empty() or solution.nb_colors() < 2) {
+        return;
+    }
+    const int nb_moves =
+        static_cast<int>(std::ceil(perturbation * static_cast<double>(vertices.size())));
+    std::uniform_int_distribution<int> distribution_colors(0, solution.nb_colors() - 2);
+    for (int i = 0; i < nb_moves; ++i) {
+        int vertex = rd::choice(vertices);
+        if (partial) {
+            // a colored neighbor of the uncolored vertex
+            const auto &neighborhood = graph->neighborhood[vertex];
+            if (neighborhood.empty()) {
+                continue;
+            }
+            vertex = rd::choice(neighborhood);
+            if (solution[vertex] == -1) {
+                continue;
+            }
+        }
+        // random color other than the current one
+        int color = distribution_colors(rd::generator);
+        if (color >= solution[vertex]) {
+            ++color;
+        }
+        solution.kempe_chain_move(vertex, color);
+    }
+}
+
+/**
+ * @brief Acceptance thresholds of the simulated annealing, for each temperature step and
+ * each worsening delta, exp(-delta / temperature) scaled to 32 bits integers. The
+ * thresholds of a step stop at the first delta never accepted.
+ */
+class AcceptanceTables {
+    std::vector<std::vector<uint32_t>> _thresholds{};
+
+  public:
+    explicit AcceptanceTables(const ParamAnnealing &param) {
+        assert(param.cooling > 0 and param.cooling < 1);
+        double temperature = param.initial_temperature;
+        do {
+            std::vector<uint32_t> thresholds;
+            for (int delta = 1;; ++delta) {
+                const double threshold =
+                    std::ldexp(std::exp(-static_cast<double>(delta) / temperature), 32);
+                if (threshold < 1) {
+                    break;
+                }
+                thresholds.emplace_back(static_cast<uint32_t>(
+                    std::min(threshold, static_cast<double>(UINT32_MAX))));
+            }
+            _thresholds.emplace_back(std::move(thresholds));
+            temperature *= param.cooling;
+        } while (temperature > param.final_temperature);
+    }
+
+    int nb_steps() const {
+        return static_cast<int>(_thresholds.size());
+    }
+
+    /**
+     * @brief Draw the acceptance of a move of delta at the step
+     */
+    bool accept(const int step, const int delta) const {
+        if (delta <= 0) {
+            return true;
+        }
+        const auto &thresholds = _thresholds[step];
+        return delta <= static_cast<int>(thresholds.size()) and
+               rd::random_uint32() < thresholds[delta - 1];
+    }
+};
+
+std::optional<Solution> simulated_annealing(Solution &best_solution,
+                                            const ParamLS &param) {
+    const auto max_time =
+        std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
+
+    int64_t best_time = 0;
+    int64_t best_turn = 0;
+    int64_t best_legal_time = 0;
+    int64_t best_legal_turn = 0;
+    std::optional<Solution> best_legal_solution = std::nullopt;
+    if (best_solution.is_legal()) {
+        best_legal_solution = best_solution;
+    }
+
+    assert(param.annealing);
+    const AcceptanceTables tables(*param.annealing);
+
+    if (best_solution.nb_uncolored() != 0) {
+        best_solution.color_uncolored();
+    }
+
+    if (parameters->use_target and best_solution.nb_colors() > parameters->nb_colors) {
+        // remove all excess colors
+        best_solution = best_solution.reduce_nb_colors_illegal(parameters->nb_colors);
+        assert(best_solution.check_solution());
+    }
+
+    Solution solution = best_solution;
+
+    long turn = 0;
+    Stagnation stagnation(param, best_solution);
+
+    while (not stop_local_search(param, max_time) and
+           turn < param.max_iterations and not stagnation.reached(turn) and
+           not(best_solution.is_legal() and
+               best_solution.nb_colors() == parameters->nb_colors)) {
+
+        if (solution.is_legal() and not parameters->use_target) {
+            // remove one color
+            solution = solution.reduce_nb_colors_illegal(solution.nb_colors() - 1);
+
+            best_solution = solution;
+            if (param.verbose) {
+                print_result_ls(best_time, best_solution, turn);
+            }
+            assert(solution.check_solution());
+        }
+
+        solution.init_deltas();
+
+        // a vertex moves to another color, there is none with one color
+        if (solution.nb_colors() < 2) {
+            break;
+        }
+        int best_found = solution.penalty();
+        std::uniform_int_distribution<int> distribution_colors(0,
+                                                               solution.nb_colors() - 2);
+        int step = 0;
+        long step_turn = 0;
+
+        turn = 0;
+        stagnation.reset();
+        while (not stop_local_search(param, max_time) and
+               turn < param.max_iterations and not stagnation.reached(turn) and
+               not best_solution.is_legal()) {
+
+            ++turn;
+
+            if (++step_turn == param.annealing->plateau) {
+                step_turn = 0;
+                // reheat at the end of the schedule
+                step = (step + 1) % tables.nb_steps();
+            }
+
+            const int vertex = rd::choice(solution.conflicting_vertices());
+            // random color other than the current one
+            int color = distribution_colors(rd::generator);
+            if (color >= solution[vertex]) {
+                ++color;
+            }
+            // colors emptied by the search are left empty
+            if (solution.color_size(color) == 0 or
+                not tables.accept(step, solution.delta_conflicts_colors(vertex, color))) {
+                continue;
+            }
+            solution.move_to_color(vertex, color);
+
+            assert(solution.check_solution());
+
+            if (solution.penalty() < best_found) {
+                best_found = solution.penalty();
+                best_solution = solution;
+                best_time =
+                    parameters->elapsed_time(std::chrono::high_resolution_clock::now());
+                best_turn = turn;
+                stagnation.improvement(turn);
+                if (param.verbose) {
+                    print_result_ls(best_time, best_solution, turn);
+                }
+            }
+        }
+        if (solution.is_legal()) {
+            best_legal_solution = solution;
+            legal_solution_found(param);
+            best_legal_time = best_time;
+            best_legal_turn = best_turn;
+        }
+    }
+    if (param.verbose) {
+        print_result_ls(best_time, best_solution, best_turn);
+        if (best_legal_solution) {
+            print_result_ls(best_legal_time, best_legal_solution, best_legal_turn);
+        }
+    }
+    assert(best_solution.check_solution());
+    return best_legal_solution;
+}
+
+std::optional<Solution> iterated_local_search(Solution &best_solution,
+                                              const ParamLS &param) {
+    const auto max_time =
+        std::chrono::high_resolution_clock::now() + std::chrono::seconds(param.max_time);
+
+    const auto &local_search = param.ils->local_search;
+
+    int64_t best_time = 0;
+    int64_t best_turn = 0;
+    std::optional<Solution> best_legal_solution = std::nullopt;
+    if (best_solution.is_legal()) {
+        best_legal_solution = best_solution;
+    }
+
+    Solution solution = best_solution;
+    long turn = 0;
+
+    while (not stop_local_search(param, max_time) and turn < param.max_iterations) {
+        ++turn;
+
+        // the local search runs until it stagnates, solution is its best solution
+        const auto legal_solution = local_search.run(solution);
+        if (legal_solution and
+            (not best_legal_solution or
+             legal_solution->nb_colors() < best_legal_solution->nb_colors())) {
+            best_legal_solution = legal_solution;
+        }
+        if (parameters->use_target and best_legal_solution and
+            best_legal_solution->nb_colors() <= parameters->nb_colors) {
+            best_solution = best_legal_solution.value();
+            best_turn = turn;
+            break;
+        }
+
+        // restart from the best solution if the local search did worse
+        if (turn == 1 or ils_score(solution) < ils_score(best_solution)) {
+            best_solution = solution;
+            best_time =
+                parameters->elapsed_time(std::chrono::high_resolution_clock::now());
+            best_turn = turn;
+            if (param.verbose) {
+                print_result_ls(best_time, best_solution, turn);
+            }
+        } else if (ils_score(solution) == ils_score(best_solution)) {
+            best_solution = solution;
+        } else {
+            solution = best_solution;
+        }
+
+        param.ils->perturbation_function(solution, param.ils->perturbation);
+        assert(solution.check_solution());
+    }
+    if (param.verbose) {
+        print_result_ls(best_time, best_solution, best_turn);
+    }
+    return best_legal_solution;
+}
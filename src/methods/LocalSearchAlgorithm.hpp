@@ -1,10 +1,49 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <optional>
 
 #include "../representation/Method.hpp"
 #include "../representation/Solution.hpp"
+#include "DsaturFinisher.hpp"
 #include "GreedyAlgorithm.hpp"
+#include "ReactiveTabu.hpp"
+
+struct ParamILS;
+
+struct ParamSampling {
+    /** @brief minimum number of vertices evaluated at each iteration*/
+    const int size;
+    /** @brief part of the conflicting (or uncolored) vertices evaluated at each
+     * iteration, when more than size*/
+    const double ratio;
+};
+
+struct ParamAnnealing {
+    /** @brief temperature of the first step of the schedule*/
+    const double initial_temperature;
+    /** @brief the schedule restarts from the initial temperature (reheat) once the
+     * temperature goes below*/
+    const double final_temperature;
+    /** @brief factor applied to the temperature at each step*/
+    const double cooling;
+    /** @brief number of iterations of each temperature step*/
+    const long plateau;
+};
+
+/**
+ * @brief Exchange of a local search with the other threads of a cooperative portfolio
+ */
+struct ParamExchange {
+    /** @brief number of iterations between two calls of the function*/
+    const long interval;
+    /** @brief set by the portfolio for its thread, receives the best solution of the
+     * local search and returns true when the thread stagnates to stop the local search*/
+    std::function<bool(const Solution &)> function{};
+};
 
 struct ParamLS {
     const std::string name;
@@ -15,6 +54,38 @@ struct ParamLS {
     const int max_time;
     const long max_iterations;
     const bool verbose;
+    /** @brief number of threads used to scan the neighborhood (tabu col)*/
+    const int scan_threads;
+    /** @brief below this number of vertices to scan, the scan is sequential*/
+    const int scan_min_vertices;
+    /** @brief only evaluate a random sample of the conflicting (or uncolored) vertices
+     * (tabu col optimized, partial col optimized)*/
+    const std::optional<ParamSampling> sampling;
+    /** @brief maximum depth of the grenade cascades (partial ts), 0 for unbounded*/
+    const int max_cascade_depth;
+    /** @brief exact completion of the solutions with few uncolored vertices (partial col,
+     * partial ts)*/
+    const std::optional<ParamFinisher> finisher;
+    /** @brief reactive tabu tenure (tabu col optimized, partial col optimized)*/
+    const std::optional<ParamReactive> reactive;
+    /** @brief cooling schedule (simulated annealing)*/
+    const std::optional<ParamAnnealing> annealing;
+    /** @brief number of increases of the edge weights between two smoothings of the
+     * weights (tabu edge), 0 to never smooth, 1 cancels the increases*/
+    const int edge_smoothing;
+    /** @brief the local search stops after this number of iterations without
+     * improvement (0 to disable)*/
+    const long stagnation_iterations;
+    /** @brief the local search stops after this number of milliseconds without
+     * improvement (0 to disable)*/
+    const long stagnation_time;
+    /** @brief parameters of the iterated local search (nullptr for other local search)*/
+    const std::shared_ptr<const ParamILS> ils;
+    /** @brief set by a thread of a portfolio to stop the others (nullptr if alone)*/
+    const std::shared_ptr<std::atomic<bool>> cancel;
+    /** @brief exchange of a thread of a cooperative portfolio, called with the stagnation
+     * detection of the local search (nullptr if alone)*/
+    const std::shared_ptr<ParamExchange> exchange;
 };
 
 /** @brief Pointer to local search function */
@@ -30,6 +101,17 @@ struct LocalSearch {
     std::optional<Solution> run(Solution &solution) const;
 };
 
+/** @brief Pointer to perturbation function of the iterated local search */
+typedef void (*perturbation_ptr)(Solution &, const double);
+
+struct ParamILS {
+    /** @brief local search iterated, stopped by its stagnation criteria*/
+    const LocalSearch local_search;
+    /** @brief part of the conflicting (or uncolored) vertices perturbed*/
+    const double perturbation;
+    const perturbation_ptr perturbation_function;
+};
+
 /**
  * @brief Method for local search
  */
@@ -55,6 +137,11 @@ class LocalSearchAlgorithm : public Method {
      */
     void run() override;
 
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
     /**
      * @brief Return method header in csv format
      *
@@ -70,6 +157,19 @@ class LocalSearchAlgorithm : public Method {
     [[nodiscard]] const std::string line_csv() const override;
 };
 
+/**
+ * @brief Return true if the local search must stop, the time limit is reached or
+ * another thread of the portfolio has cancelled the search
+ */
+bool stop_local_search(const ParamLS &param,
+                       const std::chrono::high_resolution_clock::time_point &max_time);
+
+/**
+ * @brief Cancel the other threads of the portfolio, to call when a legal solution is
+ * found
+ */
+void legal_solution_found(const ParamLS &param);
+
 /**
  * @brief Get the local search
  *
@@ -123,6 +223,72 @@ std::optional<Solution> tabu_col(Solution &solution, const ParamLS &param);
  */
 std::optional<Solution> tabu_col_optimized(Solution &solution, const ParamLS &param);
 
+/**
+ * @brief Tabu edge
+ *
+ * TabuCol on the weighted penalty, the sum of the weights of the conflicting edges. When
+ * the best move worsens the weighted penalty, the weights of the conflicting edges are
+ * increased instead (breakout) so the search leaves the local minimum, every
+ * param.edge_smoothing increases the weights are halved to forget the old minima. The
+ * best solution is the one with the least conflicting edges.
+ *
+ * Based on :
+ * Morris, P., 1993.
+ * The Breakout Method for Escaping from Local Minima.
+ * Proceedings of the Eleventh National Conference on Artificial Intelligence, 40–45.
+ */
+std::optional<Solution> tabu_edge(Solution &solution, const ParamLS &param);
+
+/**
+ * @brief Iterated local search
+ *
+ * Runs the local search of param.ils until it stagnates, keeps its best solution if it
+ * is not worse than the best one, then perturbs the best solution by moving a part of
+ * the conflicting (or uncolored) vertices to random colors and resumes the local search
+ * from there. The perturbation keeps the deltas of the local search up to date when
+ * possible so they are not initialized again.
+ */
+std::optional<Solution> iterated_local_search(Solution &best_solution,
+                                              const ParamLS &param);
+
+/**
+ * @brief Kempe col
+ *
+ * PartialCol where the best move, when it uncolors neighbors, is first replaced by a
+ * Kempe chain interchange that frees a color for the vertex
+ */
+std::optional<Solution> kempe_col(Solution &solution, const ParamLS &param);
+
+/**
+ * @brief Simulated annealing
+ *
+ * Each iteration moves a random conflicting vertex to a random other color, the move is
+ * evaluated in O(1) with the deltas of tabu col. A worsening move of delta is accepted
+ * with probability exp(-delta / temperature), read from integer thresholds computed for
+ * each temperature step of the schedule before the search.
+ *
+ * From :
+ * Johnson, D. S., Aragon, C. R., McGeoch, L. A., Schevon, C., 1991.
+ * Optimization by Simulated Annealing: An Experimental Evaluation; Part II, Graph
+ * Coloring and Number Partitioning.
+ * Operations Research 39, no. 3: 378–406.
+ * https://doi.org/10.1287/opre.39.3.378
+ */
+std::optional<Solution> simulated_annealing(Solution &solution, const ParamLS &param);
+
+/**
+ * @brief Move a part of the uncolored vertices (or of the conflicting vertices if all
+ * vertices are colored) to random colors, keeping the deltas up to date when they are
+ */
+void perturbation_random(Solution &solution, const double perturbation);
+
+/**
+ * @brief Apply Kempe chain interchanges from a part of the conflicting vertices (or from
+ * colored neighbors of the uncolored vertices) with random colors, the penalty and the
+ * uncolored vertices do not change and the deltas stay up to date
+ */
+void perturbation_kempe(Solution &solution, const double perturbation);
+
 /**
  * @brief Tabu bucket
  *
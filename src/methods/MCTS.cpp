@@ -31,7 +31,8 @@ MCTS::MCTS(greedy_fct_ptr greedy_function_, const ParamMCTS &param_)
     _t_best = std::chrono::high_resolution_clock::now();
 
     if (not parameters->use_target) {
-        Solution::best_nb_colors = _best_solution.nb_colors();
+        Solution::best_nb_colors.store(_best_solution.nb_colors(),
+                                       std::memory_order_release);
     }
 
     // Creation of the base solution and root node
@@ -87,7 +88,7 @@ bool MCTS::stop_condition() const {
 }
 
 void MCTS::run() {
-    SimulationHelper helper(Solution::best_nb_colors,
+    SimulationHelper helper(Solution::best_nb_colors.load(std::memory_order_acquire),
                             std::max(graph->nb_vertices / 10, 3),
                             std::max(graph->nb_vertices / 5, 3));
     int operator_number = 0;
@@ -148,8 +149,7 @@ void MCTS::run() {
         if (_best_solution.nb_colors() > nb_colors) {
             _t_best = std::chrono::high_resolution_clock::now();
             _best_solution = _current_solution;
-            if (Solution::best_nb_colors > nb_colors)
-                Solution::best_nb_colors = nb_colors;
+            Solution::update_best_nb_colors(nb_colors);
             fmt::print(parameters->output, "{}", line_csv());
             _current_node = nullptr;
             _root_node->clean_graph(_best_solution.nb_colors());
@@ -189,6 +189,10 @@ void MCTS::expansion() {
     }
 }
 
+[[nodiscard]] const Solution &MCTS::best_solution() const {
+    return _best_solution;
+}
+
 [[nodiscard]] const std::string MCTS::header_csv() const {
     return fmt::format("turn,time,depth,nb total node,nb "
                        "current node,height,{}\n",
@@ -227,7 +231,7 @@ std::vector<Action> next_possible_moves(const Solution &solution) {
         }
     }
     const int next_score = solution.nb_colors() + 1;
-    if (Solution::best_nb_colors > next_score) {
+    if (Solution::best_nb_colors.load(std::memory_order_acquire) > next_score) {
         if (nb_colors < degree_p1) {
             moves.emplace_back(Action{next_vertex, -1, next_score});
         }
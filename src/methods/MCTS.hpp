@@ -71,6 +71,11 @@ class MCTS : public Method {
      */
     void run() override;
 
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
     /**
      * @brief Selection phase of the MCTS algorithm
      *
@@ -15,18 +15,32 @@
 using namespace graph_instance;
 using namespace parameters_search;
 
-MemeticAlgorithm::MemeticAlgorithm(greedy_fct_ptr greedy_function_, const ParamMA &param_)
+/** @brief keys of the parallel tasks for rd::seed_task, with the turn, the index of the
+ * task and the island*/
+constexpr long task_initialization = 0;
+constexpr long task_crossover = 1;
+constexpr long task_local_search = 2;
+constexpr long task_steady_state = 3;
+
+MemeticAlgorithm::MemeticAlgorithm(greedy_fct_ptr greedy_function_,
+                                   const ParamMA &param_,
+                                   const int island_)
     : _best_solution(),
       _param(param_),
       _greedy_function(greedy_function_),
       _population(param_.population_size),
-      _t_best(std::chrono::high_resolution_clock::now()) {
+      _children(param_.nb_selected),
+      _t_best(std::chrono::high_resolution_clock::now()),
+      _ls_cache(param_.ls_cache),
+      _island(island_) {
     if (parameters->output_file != "") {
-        output_file_tbt = fmt::format("{}/tbt/{}_{}_{}.csv",
+        output_file_tbt = fmt::format("{}/tbt/{}_{}_{}{}.csv",
                                       parameters->output_directory,
                                       graph->name,
                                       parameters->rand_seed,
-                                      parameters->nb_colors);
+                                      parameters->nb_colors,
+                                      _island == -1 ? ""
+                                                    : fmt::format("_island{}", _island));
 
         std::FILE *file_tbt = std::fopen((output_file_tbt + ".running").c_str(), "w");
         if (!file_tbt) {
@@ -40,7 +54,9 @@ MemeticAlgorithm::MemeticAlgorithm(greedy_fct_ptr greedy_function_, const ParamM
     // _selected.reserve(_param.nb_selected);
     // _children.reserve(_param.nb_selected);
 
-    fmt::print(parameters->output, "{}", header_csv());
+    if (_island == -1) {
+        fmt::print(parameters->output, "{}", header_csv());
+    }
 
     // operators_str.pop_back();
     fmt::print(output_tbt, "#operators\n");
@@ -75,135 +91,275 @@ bool MemeticAlgorithm::stop_condition() const {
         ;
 }
 
-void MemeticAlgorithm::run() {
+void MemeticAlgorithm::seed_task(const long task, const long index) const {
+    if (_island == -1) {
+        rd::seed_task({_turn, task, index});
+    } else {
+        rd::seed_task({_turn, task, index, _island});
+    }
+}
+
+void MemeticAlgorithm::initialize() {
     // init population
+    std::vector<Solution> individuals(_param.population_size);
+    {
+        const rd::SavedGenerator saved_generator;
 #pragma omp parallel for
-    for (int i = 0; i < _param.population_size; i++) {
-        _greedy_function(_population[i]);
-        _population[i] = _population[i].reduce_nb_colors_illegal(parameters->nb_colors);
-        assert(_population[i].nb_colors() == parameters->nb_colors or
-               _population[i].penalty() == 0);
-    }
-
-    std::stable_sort(_population.begin(),
-                     _population.end(),
-                     [](const Solution &indiv1, const Solution &indiv2) {
-                         return indiv1.penalty() < indiv2.penalty();
-                     });
-
-    // compute the distances
-    for (int i = 0; i < _param.population_size; i++) {
-        for (int j = i + 1; j < _param.population_size; j++) {
-            const int dist = distance_accurate(_population[i], _population[j]);
-            _population[i].distances[_population[j].id] = dist;
-            _population[j].distances[_population[i].id] = dist;
+        for (int i = 0; i < _param.population_size; i++) {
+            seed_task(task_initialization, i);
+            _greedy_function(individuals[i]);
+            individuals[i] =
+                individuals[i].reduce_nb_colors_illegal(parameters->nb_colors);
+            assert(individuals[i].nb_colors() == parameters->nb_colors or
+                   individuals[i].penalty() == 0);
         }
     }
-    std::vector<Solution> elites(_population);
-    int current_elite = 0;
-    std::uniform_int_distribution<int> distribution_elite(0, 1);
-    int threshold = static_cast<int>(graph->nb_vertices * 0.99);
+    // sort by penalty and compute the distances
+    _population.reset(individuals);
+
+    _elites.clear();
+    for (int i = 0; i < _population.size(); ++i) {
+        _elites.emplace_back(_population[i]);
+    }
+    _current_elite = 0;
 
     update_best_score();
+}
+
+void MemeticAlgorithm::run_turn() {
+    // if the 2 individual for HEAD are equal
+    if (_param.insertion.param.name == "insertion_head" and
+        _population.distance(0, 1) == 0) {
+        // restart the population and elites
+        std::vector<Solution> individuals(_param.population_size);
+        _elites = std::vector<Solution>(_param.population_size);
+        for (int i = 0; i < _param.population_size; ++i) {
+            _greedy_function(individuals[i]);
+            individuals[i] =
+                individuals[i].reduce_nb_colors_illegal(parameters->nb_colors);
+            assert(individuals[i].nb_colors() == parameters->nb_colors);
+        }
+        _population.reset(individuals);
+        _greedy_function(_elites[0]);
+        _elites[0] = _elites[0].reduce_nb_colors_illegal(parameters->nb_colors);
+        _greedy_function(_elites[1]);
+        _elites[1] = _elites[1].reduce_nb_colors_illegal(parameters->nb_colors);
+    }
+    // Selection of parents
+    _selected = _param.selection.run(_population);
+
+    std::string selected_indiv_str = "";
+    std::string selected_distance_str = "";
+    for (const auto &[p1, p2] : _selected) {
+        selected_indiv_str += fmt::format("{}:{}:", p1, p2);
+        selected_distance_str += fmt::format("{}:", _population.distance(p1, p2));
+    }
+
+    // remove last ":"
+    selected_indiv_str.pop_back();
+    selected_distance_str.pop_back();
+
+    // Crossover and local search
     std::string fit_str = "";
     std::string selected_str = "";
-    while (stop_condition()) {
-        // if the 2 individual for HEAD are equal
-        if (_param.insertion.param.name == "insertion_head" and
-            _population[0].distances[_population[1].id] == 0) {
-            // restart the population and elites
-            _population = std::vector<Solution>(_param.population_size);
-            elites = std::vector<Solution>(_param.population_size);
-            for (int i = 0; i < _param.population_size; ++i) {
-                _greedy_function(_population[i]);
-                _population[i] =
-                    _population[i].reduce_nb_colors_illegal(parameters->nb_colors);
-                assert(_population[i].nb_colors() == parameters->nb_colors);
-            }
-            std::stable_sort(_population.begin(),
-                             _population.end(),
-                             [](const Solution &indiv1, const Solution &indiv2) {
-                                 return indiv1.penalty() < indiv2.penalty();
-                             });
-            for (int i = 0; i < _param.population_size; i++) {
-                for (int j = i + 1; j < _param.population_size; j++) {
-                    const int dist = distance_accurate(_population[i], _population[j]);
-                    _population[i].distances[_population[j].id] = dist;
-                    _population[j].distances[_population[i].id] = dist;
-                }
-            }
-            _greedy_function(elites[0]);
-            elites[0] = elites[0].reduce_nb_colors_illegal(parameters->nb_colors);
-            _greedy_function(elites[1]);
-            elites[1] = elites[1].reduce_nb_colors_illegal(parameters->nb_colors);
-        }
-        // Selection of parents
-        _selected = _param.selection.run(_population);
-
-        std::string selected_indiv_str = "";
-        std::string selected_distance_str = "";
-        for (const auto &[p1, p2] : _selected) {
-            selected_indiv_str += fmt::format("{}:{}:", p1, p2);
-            selected_distance_str +=
-                fmt::format("{}:", _population[p1].distances.at(_population[p2].id));
-        }
+    if (_param.adaptive_helper->param.name == "neural_net") {
+        std::tie(fit_str, selected_str) = crossover_and_mutation_neural_network();
+    } else {
+        fit_str = crossover_and_mutation();
+        selected_str = _param.adaptive_helper->get_selected_str();
+    }
 
-        // remove last ":"
-        selected_indiv_str.pop_back();
-        selected_distance_str.pop_back();
+    // Insertion
+    if (_param.insertion.param.name == "insertion_head") {
+        insertion_head();
+    } else {
+        insertion();
+    }
 
-        // Crossover and local search
-        if (_param.adaptive_helper->param.name == "neural_net") {
-            std::tie(fit_str, selected_str) = crossover_and_mutation_neural_network();
-        } else {
-            fit_str = crossover_and_mutation();
-            selected_str = _param.adaptive_helper->get_selected_str();
-        }
+    if (_population[0].penalty() <= _elites[_current_elite].penalty()) {
+        _elites[_current_elite] = _population[0];
+    }
+
+    update_best_score();
+
+    turn_by_turn_line(selected_indiv_str, selected_distance_str, fit_str, selected_str);
 
-        // Insertion
-        if (_param.insertion.param.name == "insertion_head") {
-            insertion_head();
-        } else {
-            insertion();
+    ++_turn;
+    _population.increment_ages();
+
+    // reintroduce elites in the population (for a HEAD configuration)
+    // elites to -1 or 1 mean no elites
+    // other values mean the frequency of elites
+    if ((_turn % _param.elites) == 1) { // elites = 10 by default in HEAD
+        _current_elite = (_current_elite + 1) % 2;
+        std::uniform_int_distribution<int> distribution_elite(0, 1);
+        int indiv_to_replace = distribution_elite(rd::generator);
+        const int threshold = static_cast<int>(graph->nb_vertices * 0.99);
+
+        _population.compute_candidate(_elites[_current_elite]);
+        if (_population.candidate_distance(indiv_to_replace) > threshold) {
+            indiv_to_replace = (indiv_to_replace + 1) % 2;
         }
+        _population.replace(indiv_to_replace, _elites[_current_elite]);
+    }
+}
 
-        if (_population[0].penalty() <= elites[current_elite].penalty()) {
-            elites[current_elite] = _population[0];
+void MemeticAlgorithm::run() {
+    const auto t_start = std::chrono::high_resolution_clock::now();
+    initialize();
+    if (_param.steady_state) {
+        run_steady_state();
+    } else {
+        while (stop_condition()) {
+            run_turn();
         }
+    }
 
-        update_best_score();
+    fmt::print(parameters->output, "{}", throughput_line(t_start));
+    if (_ls_cache.enabled()) {
+        fmt::print(parameters->output,
+                   "#ls_cache,{},{}\n",
+                   _ls_cache.nb_lookups(),
+                   _ls_cache.nb_hits());
+    }
+    fmt::print(parameters->output, "{}", line_csv());
+}
 
-        turn_by_turn_line(
-            selected_indiv_str, selected_distance_str, fit_str, selected_str);
+long MemeticAlgorithm::turn() const {
+    return _turn;
+}
 
-        ++_turn;
-        for (auto &indiv : _population) {
-            ++indiv.age;
+[[nodiscard]] const Solution &MemeticAlgorithm::emigrant(const bool most_distant) const {
+    if (not most_distant) {
+        return _population[0];
+    }
+    // the individual the farthest from its closest individual
+    int best_rank = 0;
+    for (int rank = 1; rank < _population.size(); ++rank) {
+        if (_population.min_distance(rank) > _population.min_distance(best_rank)) {
+            best_rank = rank;
         }
+    }
+    return _population[best_rank];
+}
 
-        // reintroduce elites in the population (for a HEAD configuration)
-        // elites to -1 or 1 mean no elites
-        // other values mean the frequency of elites
-        if ((_turn % _param.elites) == 1) { // elites = 10 by default in HEAD
-            current_elite = (current_elite + 1) % 2;
-            int indiv_to_replace = distribution_elite(rd::generator);
-
-            auto dist =
-                distance_accurate(_population[indiv_to_replace], elites[current_elite]);
-            if (dist > threshold) {
-                indiv_to_replace = (indiv_to_replace + 1) % 2;
-                dist = distance_accurate(_population[indiv_to_replace],
-                                         elites[current_elite]);
-            }
-            _population[indiv_to_replace] = elites[current_elite];
-            _population[indiv_to_replace].distances.clear();
-            _population[(indiv_to_replace + 1) % 2].distances.clear();
-            _population[0].distances[_population[1].id] = dist;
-            _population[1].distances[_population[0].id] = dist;
+void MemeticAlgorithm::immigrate(Solution &migrant) {
+    if (_param.insertion.param.name == "insertion_head") {
+        _population.compute_candidate(migrant);
+        // the migrant replaces the worst parent, unless it is a copy of the other one
+        // (which would restart the population)
+        if (_population.candidate_distance(0) != 0) {
+            _population.swap_in(_population.size() - 1, migrant);
         }
+    } else if (not _population.contains(migrant.fingerprint())) {
+        _population.compute_candidate(migrant);
+        insert(migrant);
     }
+    update_best_score();
+}
 
-    fmt::print(parameters->output, "{}", line_csv());
+void MemeticAlgorithm::run_steady_state() {
+    // children of the current turn, for the turn by turn line
+    std::vector<std::string> selected_indiv(_param.nb_selected);
+    std::vector<int> selected_distance(_param.nb_selected);
+    std::vector<int> fit_parent(_param.nb_selected);
+    std::vector<int> fit_crossover(_param.nb_selected);
+    std::vector<int> fit_local_search(_param.nb_selected);
+    long nb_started = 0;
+
+    const rd::SavedGenerator saved_generator;
+#pragma omp parallel
+    {
+        // kept by the thread to reuse their buffers
+        Solution parent1;
+        Solution parent2;
+        Solution child;
+        PopulationSnapshot snapshot;
+        while (true) {
+            bool stop = false;
+            std::string parents_str;
+            int parents_distance = 0;
+            int operator_number = 0;
+#pragma omp critical(memetic_population)
+            {
+                stop = not stop_condition();
+                if (not stop) {
+                    // each child gets its own seed, independent of the thread running it
+                    rd::seed_task({task_steady_state, nb_started++});
+                    const auto [p1, p2] = _param.selection.run_single(_population);
+                    parent1 = _population[p1];
+                    parent2 = _population[p2];
+                    _population.update_snapshot(snapshot);
+                    parents_str = fmt::format("{}:{}", p1, p2);
+                    parents_distance = _population.distance(p1, p2);
+                    operator_number = _param.adaptive_helper->get_operator();
+                }
+            }
+            if (stop) {
+                break;
+            }
+
+            // the crossover and the local search run without lock
+            const auto &[cross, ls] = _param.pairs_x_ls[operator_number];
+            child.reset();
+            _param.crossover[cross].run(parent1, parent2, child);
+            assert(child.nb_colors() == parameters->nb_colors);
+            const int penalty_crossover = child.penalty();
+            bool cached = false;
+            uint64_t fingerprint = 0;
+            if (_ls_cache.enabled()) {
+                fingerprint = child.fingerprint();
+#pragma omp critical(memetic_ls_cache)
+                cached = _ls_cache.find(fingerprint, ls, child);
+            }
+            if (not cached) {
+                _param.local_search[ls].run(child);
+                if (_ls_cache.enabled()) {
+#pragma omp critical(memetic_ls_cache)
+                    _ls_cache.store(fingerprint, ls, child);
+                }
+            }
+            assert(child.check_solution());
+            assert(child.nb_colors() == parameters->nb_colors);
+            // the distances to the population are computed without lock, only the ones
+            // to the individuals replaced since the selection are computed again
+            snapshot.compute_candidate(child);
+
+#pragma omp critical(memetic_population)
+            {
+                const int index = static_cast<int>(_nb_children % _param.nb_selected);
+                ++_nb_children;
+                selected_indiv[index] = parents_str;
+                selected_distance[index] = parents_distance;
+                fit_parent[index] = parent1.penalty();
+                fit_crossover[index] = penalty_crossover;
+                fit_local_search[index] = child.penalty();
+                _param.adaptive_helper->update_obtained_solution(
+                    index, operator_number, child.penalty());
+
+                if (not _population.contains(snapshot.fingerprint)) {
+                    _population.compute_candidate(snapshot, child);
+                    insert(child);
+                    update_best_score();
+                }
+
+                if (index == _param.nb_selected - 1) {
+                    // end of the turn
+                    _param.adaptive_helper->update_helper();
+                    turn_by_turn_line(
+                        fmt::format("{}", fmt::join(selected_indiv, ":")),
+                        fmt::format("{}", fmt::join(selected_distance, ":")),
+                        fmt::format("{},{},{}",
+                                    fmt::join(fit_parent, ":"),
+                                    fmt::join(fit_crossover, ":"),
+                                    fmt::join(fit_local_search, ":")),
+                        _param.adaptive_helper->get_selected_str());
+                    ++_turn;
+                    _population.increment_ages();
+                }
+            }
+        }
+    }
 }
 
 std::string MemeticAlgorithm::crossover_and_mutation() {
@@ -228,16 +384,23 @@ std::string MemeticAlgorithm::crossover_and_mutation() {
         }
     }
 
-    _children = std::vector<Solution>(_param.nb_selected);
-
-    // Crossover
+    // Crossover, the children are reset to reuse their buffers
+    std::vector<uint64_t> fingerprints(_param.nb_selected, 0);
+    {
+        const rd::SavedGenerator saved_generator;
 #pragma omp parallel for
-    for (int i = 0; i < _param.nb_selected; ++i) {
-        auto &[cross, ls] = _param.pairs_x_ls[pair_operators[i]];
-        _param.crossover[cross].run(_population[_selected[i].first],
-                                    _population[_selected[i].second],
-                                    _children[i]);
-        assert(_children[i].nb_colors() == parameters->nb_colors);
+        for (int i = 0; i < _param.nb_selected; ++i) {
+            seed_task(task_crossover, i);
+            auto &[cross, ls] = _param.pairs_x_ls[pair_operators[i]];
+            _children[i].reset();
+            _param.crossover[cross].run(_population[_selected[i].first],
+                                        _population[_selected[i].second],
+                                        _children[i]);
+            assert(_children[i].nb_colors() == parameters->nb_colors);
+            if (_ls_cache.enabled()) {
+                fingerprints[i] = _children[i].fingerprint();
+            }
+        }
     }
 
     for (const auto &child : _children) {
@@ -246,14 +409,36 @@ std::string MemeticAlgorithm::crossover_and_mutation() {
     fit_str.pop_back();
     fit_str += ",";
 
-    // Local Search
+    // Local Search, skipped for the children found in the cache
+    std::vector<char> cached(_param.nb_selected, 0);
+    if (_ls_cache.enabled()) {
+        for (int i = 0; i < _param.nb_selected; i++) {
+            const int ls = std::get<1>(_param.pairs_x_ls[pair_operators[i]]);
+            cached[i] = _ls_cache.find(fingerprints[i], ls, _children[i]);
+        }
+    }
+    {
+        const rd::SavedGenerator saved_generator;
 #pragma omp parallel for
-    for (int i = 0; i < _param.nb_selected; i++) {
-        auto &[cross, ls] = _param.pairs_x_ls[pair_operators[i]];
-        assert(_children[i].nb_colors() == parameters->nb_colors);
-        _param.local_search[ls].run(_children[i]);
-        assert(_children[i].check_solution());
-        assert(_children[i].nb_colors() == parameters->nb_colors);
+        for (int i = 0; i < _param.nb_selected; i++) {
+            if (cached[i]) {
+                continue;
+            }
+            seed_task(task_local_search, i);
+            auto &[cross, ls] = _param.pairs_x_ls[pair_operators[i]];
+            assert(_children[i].nb_colors() == parameters->nb_colors);
+            _param.local_search[ls].run(_children[i]);
+            assert(_children[i].check_solution());
+            assert(_children[i].nb_colors() == parameters->nb_colors);
+        }
+    }
+    if (_ls_cache.enabled()) {
+        for (int i = 0; i < _param.nb_selected; i++) {
+            if (not cached[i]) {
+                const int ls = std::get<1>(_param.pairs_x_ls[pair_operators[i]]);
+                _ls_cache.store(fingerprints[i], ls, _children[i]);
+            }
+        }
     }
 
     for (int i = 0; i < _param.nb_selected; i++) {
@@ -290,8 +475,6 @@ MemeticAlgorithm::crossover_and_mutation_neural_network() {
     // compute all possible crossovers from 2 parents
     // const int nb_operator = static_cast<int>(_crossover_cb.size());
 
-    _children = std::vector<Solution>(_param.nb_selected);
-
     std::vector<int> selected_crossover(_param.nb_selected, -1);
 
     std::vector<std::vector<Solution>> childrens(_param.nb_selected);
@@ -299,17 +482,21 @@ MemeticAlgorithm::crossover_and_mutation_neural_network() {
         childrens[i] = std::vector<Solution>(_param.crossover.size());
     }
 
+    {
+        const rd::SavedGenerator saved_generator;
 #pragma omp parallel for
-    for (int i = 0; i < _param.nb_selected; ++i) {
-        auto children = childrens[i];
-        for (size_t o = 0; o < _param.crossover.size(); ++o) {
-            _param.crossover[o].run(_population[_selected[i].first],
-                                    _population[_selected[i].second],
-                                    children[o]);
+        for (int i = 0; i < _param.nb_selected; ++i) {
+            seed_task(task_crossover, i);
+            auto children = childrens[i];
+            for (size_t o = 0; o < _param.crossover.size(); ++o) {
+                _param.crossover[o].run(_population[_selected[i].first],
+                                        _population[_selected[i].second],
+                                        children[o]);
+            }
+            const int best_child = casted_adaptive->select_best(children);
+            selected_crossover[i] = best_child;
+            _children[i] = children[best_child];
         }
-        const int best_child = casted_adaptive->select_best(children);
-        selected_crossover[i] = best_child;
-        _children[i] = children[best_child];
     }
 
     for (const auto &child : _children) {
@@ -325,10 +512,13 @@ MemeticAlgorithm::crossover_and_mutation_neural_network() {
     }
 
     // Local search
-
+    {
+        const rd::SavedGenerator saved_generator;
 #pragma omp parallel for
-    for (int i = 0; i < _param.nb_selected; i++) {
-        _param.local_search[selected_local_search[i]].run(_children[i]);
+        for (int i = 0; i < _param.nb_selected; i++) {
+            seed_task(task_local_search, i);
+            _param.local_search[selected_local_search[i]].run(_children[i]);
+        }
     }
 
     for (int i = 0; i < _param.nb_selected; i++) {
@@ -356,43 +546,31 @@ MemeticAlgorithm::crossover_and_mutation_neural_network() {
 }
 
 void MemeticAlgorithm::insertion() {
-    while (not _children.empty()) {
-        auto child = _children.back();
-        _children.pop_back();
-        insert(child);
+    _nb_children += static_cast<long>(_children.size());
+    // distances of all the children to the population at once
+    _population.compute_candidates(_children);
+    for (int child = static_cast<int>(_children.size()) - 1; child >= 0; --child) {
+        // a child already in the population is not inserted a second time
+        _population.select_candidate(child);
+        if (_population.contains(_population.candidate_fingerprint())) {
+            continue;
+        }
+        insert(_children[child]);
     }
 }
 
 void MemeticAlgorithm::insertion_head() {
-    _population = _children;
-    _children.clear();
-
-    const int dist = distance_accurate(_population[0], _population[1]);
-    _population[0].distances[_population[1].id] = dist;
-    _population[1].distances[_population[0].id] = dist;
-
-    // sort the population by penalty
-    std::stable_sort(_population.begin(),
-                     _population.end(),
-                     [](const Solution &s1, const Solution &s2) {
-                         return s1.penalty() < s2.penalty();
-                     });
+    _nb_children += static_cast<long>(_children.size());
+    // sort the population by penalty and compute the distance
+    // the children get the former individuals, reset at the next turn
+    _population.reset(_children);
 }
 
 void MemeticAlgorithm::insert(Solution &child) {
-    // Compute the distances to the child
-    // std::vector<int> distances_to_child(_param.population_size, 0);
-    for (size_t i = 0; i < _population.size(); ++i) {
-        const int dist = distance_accurate(child, _population[i]);
-        child.distances[_population[i].id] = dist;
-        _population[i].distances[child.id] = dist;
-        // distances_to_child[i] = distance_accurate(_population[i], child);
-    }
-
     int to_remove = _param.insertion.run(_population, child);
 
     assert(to_remove >= -1);
-    assert(to_remove < static_cast<int>(_population.size()));
+    assert(to_remove < _population.size());
 
     if (to_remove == -1) {
         // the worst solution is the child so it should not be added
@@ -401,36 +579,20 @@ void MemeticAlgorithm::insert(Solution &child) {
         if (distribution(rd::generator) < 10) {
             // the child is accepted
             // so the worst solution is removed
-            to_remove = static_cast<int>(_population.size()) - 1;
+            to_remove = _population.size() - 1;
         }
     }
 
-    // if the child is not inserted, remove it from the distances
     if (to_remove == -1) {
-        for (size_t i = 0; i < _population.size(); ++i) {
-            _population[i].distances.erase(child.id);
-        }
         return;
     }
 
-    // remove the deleted solution from the population
-    // and from the distances of each solution of the population
-    auto id_to_remove = _population[to_remove].id;
-    for (size_t i = 0; i < _population.size(); ++i) {
-        _population[i].distances.erase(id_to_remove);
-    }
-    child.distances.erase(id_to_remove);
-    // remove the to_remove index from the population
-    _population.erase(_population.begin() + to_remove);
-
-    _population.push_back(child);
+    // replace the deleted solution, the population stays sorted by penalty
+    _population.swap_in(to_remove, child);
+}
 
-    // sort the population by penalty
-    std::stable_sort(_population.begin(),
-                     _population.end(),
-                     [](const Solution &s1, const Solution &s2) {
-                         return s1.penalty() < s2.penalty();
-                     });
+[[nodiscard]] const Solution &MemeticAlgorithm::best_solution() const {
+    return _best_solution;
 }
 
 [[nodiscard]] const std::string MemeticAlgorithm::header_csv() const {
@@ -447,43 +609,37 @@ void MemeticAlgorithm::update_best_score() {
         _population[0].penalty()) {
         _t_best = std::chrono::high_resolution_clock::now();
         _best_solution = _population[0];
-        fmt::print(parameters->output, "{}", line_csv());
+        Solution::update_best_penalty(_best_solution.penalty());
+        if (_island == -1) {
+            fmt::print(parameters->output, "{}", line_csv());
+        }
     }
 }
 
+[[nodiscard]] std::string MemeticAlgorithm::throughput_line(
+    const std::chrono::high_resolution_clock::time_point &t_start) const {
+    const long time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::high_resolution_clock::now() - t_start)
+                          .count();
+    return fmt::format("#throughput,{},{},{},{:.1f}\n",
+                       _param.steady_state ? "steady_state" : "generational",
+                       _nb_children,
+                       time,
+                       static_cast<double>(_nb_children) * 1000 /
+                           static_cast<double>(std::max(time, 1L)));
+}
+
 void MemeticAlgorithm::turn_by_turn_line(const std::string &selected_indiv_str,
                                          const std::string &selected_distance_str,
                                          const std::string &fit_str,
                                          const std::string &selected_str) {
     double mean_fit = 0;
-    double mean_dist = 0;
-    double min_dist = graph->nb_vertices;
-    double max_dist = 0;
-    int nb_distances = 0;
-    for (size_t indiv = 0; indiv < _population.size(); ++indiv) {
+    std::string ages{};
+    for (int indiv = 0; indiv < _population.size(); ++indiv) {
         mean_fit += _population[indiv].penalty();
-        for (size_t indiv2 = 0; indiv2 < _population.size(); ++indiv2) {
-            if (indiv == indiv2) {
-                continue;
-            }
-            const int distance_ = _population[indiv].distances.at(_population[indiv2].id);
-            mean_dist += distance_;
-            ++nb_distances;
-            if (distance_ < min_dist) {
-                min_dist = distance_;
-            }
-            if (distance_ > max_dist) {
-                max_dist = distance_;
-            }
-        }
+        ages += std::to_string(_population[indiv].age) + ":";
     }
-    mean_dist /= nb_distances;
     mean_fit /= static_cast<double>(_population.size());
-
-    std::string ages{};
-    for (const auto &indiv : _population) {
-        ages += std::to_string(indiv.age) + ":";
-    }
     // delete the last ":"
     ages.pop_back();
 
@@ -500,8 +656,8 @@ void MemeticAlgorithm::turn_by_turn_line(const std::string &selected_indiv_str,
                mean_fit,
                _population.back().penalty(),
                ages,
-               min_dist,
-               mean_dist,
-               max_dist);
+               _population.min_distance(),
+               _population.mean_distance(),
+               _population.max_distance());
     _param.adaptive_helper->increment_turn();
 }
@@ -2,7 +2,9 @@
 
 #include <tuple>
 
+#include "../representation/LocalSearchCache.hpp"
 #include "../representation/Method.hpp"
+#include "../representation/Population.hpp"
 #include "../representation/Solution.hpp"
 #include "GreedyAlgorithm.hpp"
 #include "LocalSearchAlgorithm.hpp"
@@ -25,11 +27,35 @@ struct ParamMA {
     std::vector<std::string> x_ls_names;
     std::shared_ptr<AdaptiveHelper> adaptive_helper;
     long elites;
+    /** @brief each child is inserted as soon as its local search ends instead of waiting
+     * for the generation (no insertion_head nor neural_net)*/
+    bool steady_state;
+    /** @brief maximum number of local search results kept to skip the local search of a
+     * child already seen, 0 to disable (not used with neural_net)*/
+    int ls_cache;
 };
 
 /**
  * @brief Method for Memetic algorithm
  *
+ * In the generational mode, the children of a turn are created in parallel then inserted
+ * together. In the steady state mode, each thread repeatedly selects two parents, runs
+ * the crossover and the local search and inserts its child, the population and the
+ * adaptive helper are only locked during the selection and the insertion. The distances
+ * from the child to the population are computed without lock on a snapshot of the
+ * population taken at the selection, the insertion only computes again the distances to
+ * the individuals replaced since. A turn is then nb_selected inserted children. The
+ * number of children per second is printed at the end on a line
+ * #throughput,mode,nb children,time (ms),children per second.
+ *
+ * A child already in the population (same fingerprint) is not inserted. With ls_cache,
+ * the results of the last local searches are kept by fingerprint of the child and local
+ * search, a child seen again gets the result without local search. The use of the cache
+ * is printed at the end on a line #ls_cache,nb lookups,nb hits.
+ *
+ * An island of an IslandModel does not print its lines on the output, it is driven turn
+ * by turn with initialize and run_turn and exchanges individuals with emigrant and
+ * immigrate.
  */
 class MemeticAlgorithm : public Method {
 
@@ -41,17 +67,20 @@ class MemeticAlgorithm : public Method {
     /** @brief Init function*/
     greedy_fct_ptr _greedy_function;
 
-    /** @brief Current population*/
-    std::vector<Solution> _population;
+    /** @brief Current population, with the distances between its individuals*/
+    Population _population;
 
     /** @brief Selected solutions*/
     std::vector<std::pair<int, int>> _selected;
-    /** @brief Children solutions*/
+    /** @brief Children solutions, kept from one turn to the next to reuse their
+     * buffers*/
     std::vector<Solution> _children;
     /** @brief Time before founding best score*/
     std::chrono::high_resolution_clock::time_point _t_best;
     /** @brief Current turn of search*/
     long _turn = 0;
+    /** @brief Number of children evaluated and given to the insertion*/
+    long _nb_children = 0;
     /** @brief Functions of pairs of operators to call*/
     std::vector<std::tuple<crossover_ptr, int, local_search_ptr>>
         _crossover_and_local_search;
@@ -59,9 +88,23 @@ class MemeticAlgorithm : public Method {
     std::string output_file_tbt;
     /** @brief Output for turn by turn info, stdout default else output_directory/tbt */
     std::FILE *output_tbt = nullptr;
+    /** @brief Individuals reintroduced in the population (HEAD) and the next one*/
+    std::vector<Solution> _elites{};
+    int _current_elite = 0;
+    /** @brief Results of the last local searches*/
+    LocalSearchCache _ls_cache;
+    /** @brief Index of the island in an IslandModel, -1 for a single population*/
+    const int _island;
+
+    /**
+     * @brief Seed the generator of the current thread for the task of the turn
+     */
+    void seed_task(const long task, const long index) const;
 
   public:
-    explicit MemeticAlgorithm(greedy_fct_ptr greedy_function_, const ParamMA &param_);
+    explicit MemeticAlgorithm(greedy_fct_ptr greedy_function_,
+                              const ParamMA &param_,
+                              const int island_ = -1);
 
     ~MemeticAlgorithm();
 
@@ -78,12 +121,53 @@ class MemeticAlgorithm : public Method {
      */
     void run() override;
 
+    /**
+     * @brief Create the population and the elites
+     */
+    void initialize();
+
+    /**
+     * @brief One generation : selection, crossover and local search, insertion
+     */
+    void run_turn();
+
+    long turn() const;
+
+    /**
+     * @brief Return the individual sent to another island, the best one or the one the
+     * farthest from its closest individual
+     */
+    [[nodiscard]] const Solution &emigrant(const bool most_distant) const;
+
+    /**
+     * @brief Insert the individual coming from another island in the population, the
+     * migrant can get the removed individual
+     */
+    void immigrate(Solution &migrant);
+
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
     std::string crossover_and_mutation();
 
     std::tuple<std::string, std::string> crossover_and_mutation_neural_network();
 
+    /**
+     * @brief Steady state search, run until the stop condition by all the threads
+     */
+    void run_steady_state();
+
     void insertion_head();
 
+    /**
+     * @brief Insertion of the child in the population, its distances to the population
+     * must be the candidate of the population, the child gets the removed individual
+     *
+     * The callers skip the children already in the population before computing their
+     * distances.
+     */
     void insert(Solution &child);
 
     /**
@@ -107,6 +191,13 @@ class MemeticAlgorithm : public Method {
     [[nodiscard]] const std::string line_csv() const override;
 
     void update_best_score();
+
+    /**
+     * @brief Return the number of children per second since the start in csv format
+     */
+    [[nodiscard]] std::string throughput_line(
+        const std::chrono::high_resolution_clock::time_point &t_start) const;
+
     void turn_by_turn_line(const std::string &selected_indiv_str,
                            const std::string &selected_distance_str,
                            const std::string &fit_str,
@@ -0,0 +1,294 @@
+#include "PortfolioAlgorithm.hpp"
+
+#include <cassert>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#include <fmt/printf.h>
+#pragma GCC diagnostic pop
+
+#include "../representation/Graph.hpp"
+#include "../representation/Parameters.hpp"
+#include "../utils/random_generator.hpp"
+
+using namespace graph_instance;
+using namespace parameters_search;
+
+namespace {
+/** @brief Buffer published in the word of an elite slot, -1 for an empty slot*/
+int published_buffer(const uint64_t word) {
+    return static_cast<int>(word & 0xFFFFFFFFULL) - 1;
+}
+
+/** @brief Conflicts of a solution, or uncolored vertices of a partial solution*/
+int elite_score(const Solution &solution) {
+    return std::max(solution.penalty(), solution.nb_uncolored());
+}
+
+/** @brief Word of an elite slot publishing the buffer in the next version*/
+uint64_t publish_word(const uint64_t word, const int buffer) {
+    return (((word >> 32) + 1) << 32) | static_cast<uint64_t>(buffer + 1);
+}
+} // namespace
+
+PortfolioAlgorithm::PortfolioAlgorithm(greedy_fct_ptr greedy_function_,
+                                       const ParamPortfolio &param_)
+    : _best_solution(),
+      _param(param_),
+      _greedy_function(greedy_function_),
+      _t_best(std::chrono::high_resolution_clock::now()),
+      _nb_buffers((param_.nb_threads + param_.elite_size - 1) / param_.elite_size + 2),
+      _elite_buffers(static_cast<size_t>(param_.elite_size * _nb_buffers)),
+      _elites(static_cast<size_t>(param_.elite_size)) {
+    fmt::print(parameters->output, "{}", header_csv());
+}
+
+bool PortfolioAlgorithm::stop_condition() const {
+    return (_turn < _param.max_iterations) and (not parameters->time_limit_reached()) and
+           not(parameters->use_target and _best_solution.is_legal() and
+               _best_solution.nb_colors() <= parameters->nb_colors);
+}
+
+void PortfolioAlgorithm::run() {
+    _greedy_function(_best_solution);
+    assert(_best_solution.check_solution());
+    fmt::print(parameters->output, "{}", line_csv());
+
+    const int nb_threads = _param.nb_threads;
+    const int nb_local_search = static_cast<int>(_param.local_search.size());
+    std::vector<Solution> solutions(nb_threads);
+    std::vector<std::optional<Solution>> results(nb_threads);
+
+    while (stop_condition()) {
+        ++_turn;
+        _param.cancel->store(false);
+        for (auto &elite : _elites) {
+            elite.store(0);
+        }
+
+        const rd::SavedGenerator saved_generator;
+#pragma omp parallel for num_threads(nb_threads) schedule(static, 1)
+        for (int thread = 0; thread < nb_threads; ++thread) {
+            // each thread gets its own seed, the same for a given turn
+            rd::seed_task({_turn, thread});
+            solutions[thread] = _best_solution;
+            if (_param.exchange_interval > 0) {
+                results[thread] = cooperative_search(thread, solutions[thread]);
+            } else {
+                results[thread] = _param.local_search[thread % nb_local_search].run(
+                    solutions[thread]);
+            }
+        }
+
+        const int64_t time =
+            parameters->elapsed_time(std::chrono::high_resolution_clock::now());
+        int best_thread = -1;
+        for (int thread = 0; thread < nb_threads; ++thread) {
+            // best solution reached by the thread, legal or not
+            fmt::print(parameters->output,
+                       "{},{},{},{},{}\n",
+                       _turn,
+                       time,
+                       thread,
+                       _param.local_search[thread % nb_local_search].param.pseudo,
+                       solutions[thread].format());
+            if (not results[thread]) {
+                continue;
+            }
+            const int nb_colors = results[thread]->nb_colors();
+            if (nb_colors < _best_solution.nb_colors() and
+                (best_thread == -1 or nb_colors < results[best_thread]->nb_colors())) {
+                best_thread = thread;
+            }
+        }
+
+        if (best_thread == -1) {
+            if (_param.cancel->load()) {
+                // legal solution found but not better, start again from the best
+                continue;
+            }
+            // no thread found a better legal solution before the end of the time
+            break;
+        }
+        _best_solution = results[best_thread].value();
+        _best_thread = best_thread;
+        _t_best = std::chrono::high_resolution_clock::now();
+    }
+    fmt::print(parameters->output, "{}", line_csv());
+}
+
+std::optional<Solution> PortfolioAlgorithm::cooperative_search(const int thread,
+                                                               Solution &solution) {
+    const LocalSearch &local_search = _param.local_search[static_cast<size_t>(thread)];
+    int best_score = std::numeric_limits<int>::max();
+    int nb_stagnation = 0;
+    // called by the local search every exchange_interval iterations, without stopping it
+    // until the thread stagnates
+    local_search.param.exchange->function = [&](const Solution &best_solution) {
+        publish_elite(thread, best_solution);
+        if (elite_score(best_solution) < best_score) {
+            best_score = elite_score(best_solution);
+            nb_stagnation = 0;
+            return false;
+        }
+        ++nb_stagnation;
+        return nb_stagnation >= _param.stagnation;
+    };
+    std::optional<Solution> result = std::nullopt;
+    while (not _param.cancel->load(std::memory_order_relaxed) and
+           not parameters->time_limit_reached()) {
+        result = local_search.run(solution);
+        if (result and result->nb_colors() < _best_solution.nb_colors()) {
+            break;
+        }
+        result = std::nullopt;
+        if (nb_stagnation >= _param.stagnation) {
+            restart_from_elite(thread, solution);
+        }
+        best_score = std::numeric_limits<int>::max();
+        nb_stagnation = 0;
+    }
+    // the function refers to the variables of this call
+    local_search.param.exchange->function = nullptr;
+    return result;
+}
+
+void PortfolioAlgorithm::publish_elite(const int thread, const Solution &solution) {
+    const size_t slot = static_cast<size_t>(thread) % _elites.size();
+    std::atomic<uint64_t> &word = _elites[slot];
+    EliteBuffer *buffers = &_elite_buffers[slot * static_cast<size_t>(_nb_buffers)];
+    // the elites of an other number of colors are from a previous turn, the score of
+    // an elite replaced meanwhile is checked again by the compare and swap
+    const auto better = [&](const uint64_t elite_word) {
+        const int elite = published_buffer(elite_word);
+        return elite == -1 or buffers[elite].nb_colors.load() != solution.nb_colors() or
+               elite_score(solution) < buffers[elite].score.load();
+    };
+    uint64_t elite_word = word.load();
+    if (not better(elite_word)) {
+        return;
+    }
+
+    // claim a buffer without reader, which is not the published one
+    int claimed = -1;
+    for (int buffer = 0; buffer < _nb_buffers and claimed == -1; ++buffer) {
+        int free = 0;
+        if (not buffers[buffer].state.compare_exchange_strong(free, -1)) {
+            continue;
+        }
+        if (published_buffer(word.load()) == buffer) {
+            buffers[buffer].state.store(0);
+        } else {
+            claimed = buffer;
+        }
+    }
+    if (claimed == -1) {
+        return;
+    }
+    EliteBuffer &buffer = buffers[claimed];
+    buffer.solution = solution;
+    buffer.score.store(elite_score(solution));
+    buffer.nb_colors.store(solution.nb_colors());
+
+    elite_word = word.load();
+    while (better(elite_word)) {
+        if (word.compare_exchange_weak(elite_word, publish_word(elite_word, claimed))) {
+            break;
+        }
+    }
+    buffer.state.store(0);
+}
+
+bool PortfolioAlgorithm::read_elite(const size_t slot, Solution &elite) {
+    const int published = published_buffer(_elites[slot].load());
+    if (published == -1) {
+        return false;
+    }
+    EliteBuffer &buffer = _elite_buffers[slot * static_cast<size_t>(_nb_buffers) +
+                                         static_cast<size_t>(published)];
+    // hold the buffer, unless a writer owns it
+    int nb_readers = buffer.state.load();
+    do {
+        if (nb_readers == -1) {
+            return false;
+        }
+    } while (not buffer.state.compare_exchange_weak(nb_readers, nb_readers + 1));
+    // the buffer can have been replaced before being held
+    const bool still_published = published_buffer(_elites[slot].load()) == published;
+    if (still_published) {
+        elite = buffer.solution;
+    }
+    buffer.state.fetch_sub(1);
+    return still_published;
+}
+
+void PortfolioAlgorithm::restart_from_elite(const int thread, Solution &solution) {
+    // the crossover needs complete solutions, a partial local search uncolors the
+    // conflicting vertices again
+    if (solution.nb_uncolored() != 0) {
+        solution.color_uncolored();
+    }
+    const size_t own_slot = static_cast<size_t>(thread) % _elites.size();
+    std::vector<size_t> slots;
+    for (size_t slot = 0; slot < _elites.size(); ++slot) {
+        if (slot == own_slot and _elites.size() > 1) {
+            continue;
+        }
+        const int published = published_buffer(_elites[slot].load());
+        if (published != -1 and
+            _elite_buffers[slot * static_cast<size_t>(_nb_buffers) +
+                           static_cast<size_t>(published)]
+                    .nb_colors.load() == solution.nb_colors()) {
+            slots.emplace_back(slot);
+        }
+    }
+    Solution elite;
+    if (not slots.empty() and read_elite(rd::choice(slots), elite)) {
+        if (elite.nb_uncolored() != 0) {
+            elite.color_uncolored();
+        }
+        // completing a partial elite and the crossover can open new colors
+        if (elite.nb_colors() == solution.nb_colors()) {
+            Solution child;
+            _param.crossover.run(solution, elite, child);
+            if (child.nb_colors() == solution.nb_colors()) {
+                solution = child;
+            }
+        }
+    }
+
+    const int nb_perturbations =
+        static_cast<int>(_param.perturbation * static_cast<double>(graph->nb_vertices));
+    std::uniform_int_distribution<int> distribution_vertices(0, graph->nb_vertices - 1);
+    std::uniform_int_distribution<int> distribution_colors(0, solution.nb_colors() - 1);
+    for (int i = 0; i < nb_perturbations; ++i) {
+        const int vertex = distribution_vertices(rd::generator);
+        if (solution[vertex] != -1) {
+            solution.delete_from_color(vertex);
+        }
+        solution.add_to_color(vertex, distribution_colors(rd::generator));
+    }
+    assert(solution.check_solution());
+}
+
+[[nodiscard]] const Solution &PortfolioAlgorithm::best_solution() const {
+    return _best_solution;
+}
+
+[[nodiscard]] const std::string PortfolioAlgorithm::header_csv() const {
+    return fmt::format("turn,time,thread,local_search,{}\n", Solution::header_csv);
+}
+
+[[nodiscard]] const std::string PortfolioAlgorithm::line_csv() const {
+    return fmt::format(
+        "{},{},{},{},{}\n",
+        _turn,
+        parameters->elapsed_time(_t_best),
+        _best_thread,
+        _best_thread == -1
+            ? "greedy"
+            : _param.local_search[static_cast<size_t>(_best_thread) %
+                                  _param.local_search.size()]
+                  .param.pseudo,
+        _best_solution.format());
+}
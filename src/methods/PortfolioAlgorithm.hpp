@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "../representation/Method.hpp"
+#include "../representation/Solution.hpp"
+#include "GreedyAlgorithm.hpp"
+#include "LocalSearchAlgorithm.hpp"
+#include "crossover.hpp"
+
+struct ParamPortfolio {
+    const std::string name;
+    /** @brief number of local searches run in parallel*/
+    const int nb_threads;
+    const long max_iterations;
+    /** @brief local searches of the threads, thread t uses local_search[t % size], one
+     * for each thread with an exchange interval*/
+    const std::vector<LocalSearch> local_search;
+    /** @brief shared with the ParamLS of the local searches to stop the threads*/
+    const std::shared_ptr<std::atomic<bool>> cancel;
+    /** @brief iterations of local search between two exchanges with the elite pool
+     * (0 for independent threads), only the local searches with a stagnation detection
+     * exchange (not tabu_bucket and iterated_local_search)*/
+    const long exchange_interval;
+    /** @brief number of exchanges without improvement before restarting from an elite*/
+    const int stagnation;
+    /** @brief number of solutions in the elite pool*/
+    const int elite_size;
+    /** @brief part of the vertices moved to a random color when restarting*/
+    const double perturbation;
+    /** @brief crossover between the solution of the thread and an elite to restart*/
+    const Crossover crossover;
+};
+
+/**
+ * @brief Buffer of a slot of the elite pool, its state is the number of threads reading
+ * the solution or -1 while a thread writes it
+ */
+struct EliteBuffer {
+    std::atomic<int> state{0};
+    /** @brief score (conflicts or uncolored vertices) and number of colors of the
+     * solution, read without holding the buffer*/
+    std::atomic<int> score{0};
+    std::atomic<int> nb_colors{0};
+    Solution solution{};
+};
+
+/**
+ * @brief Method for a portfolio of local searches
+ *
+ * Runs in parallel one local search per thread, each with its own random seed, from the
+ * best solution. As soon as a thread finds a legal solution (with k colors or with a new
+ * best number of colors without target), the other threads are cancelled. Without
+ * target, the threads start again from the new best solution until the time limit.
+ *
+ * With an exchange interval, the threads cooperate: every exchange_interval iterations
+ * each thread publishes its best solution in a shared elite pool without stopping its
+ * local search. A thread that does not improve for stagnation exchanges stops its local
+ * search and restarts it from the crossover of its solution with an elite of another
+ * thread, followed by a random perturbation.
+ *
+ * The elite pool is lock free. Each slot has a few buffers and an atomic word with the
+ * published buffer and a version. A writer claims a free buffer, copies its solution in
+ * it and publishes it with a compare and swap on the word if it is still better than the
+ * elite. A reader holds the published buffer while it copies it, a writer never claims a
+ * buffer held by a reader. A thread which can not claim or hold a buffer skips the
+ * exchange instead of waiting.
+ */
+class PortfolioAlgorithm : public Method {
+
+    /** @brief Best found solution*/
+    Solution _best_solution;
+
+    const ParamPortfolio _param;
+
+    /** @brief Init function*/
+    greedy_fct_ptr _greedy_function;
+
+    /** @brief Time before founding best score*/
+    std::chrono::high_resolution_clock::time_point _t_best;
+    /** @brief Current turn of search (one turn for each new best solution)*/
+    long _turn = 0;
+    /** @brief Thread that found the best solution (-1 for the initialization)*/
+    int _best_thread = -1;
+    /** @brief Number of buffers of each slot of the elite pool, one for each thread of
+     * the slot plus the published buffer and one for the readers*/
+    const int _nb_buffers;
+    /** @brief Buffers of the elite pool, slot s uses the buffers s * nb_buffers to
+     * (s + 1) * nb_buffers - 1*/
+    std::vector<EliteBuffer> _elite_buffers;
+    /** @brief For each slot of the elite pool, version << 32 | (published buffer + 1), 0
+     * in the low bits for an empty slot, thread t publishes in the slot t % elite_size*/
+    std::vector<std::atomic<uint64_t>> _elites;
+
+    /**
+     * @brief Copy the elite of the slot, return false if the slot is empty or its buffer
+     * is being replaced
+     */
+    bool read_elite(const size_t slot, Solution &elite);
+
+  public:
+    explicit PortfolioAlgorithm(greedy_fct_ptr greedy_function_,
+                                const ParamPortfolio &param_);
+
+    ~PortfolioAlgorithm() override = default;
+
+    /**
+     * @brief Stopping condition for the PortfolioAlgorithm depending on turn or time
+     * limit
+     *
+     * @return true continue the search
+     * @return false stop the search
+     */
+    bool stop_condition() const;
+
+    /**
+     * @brief Run function for the method
+     */
+    void run() override;
+
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] const Solution &best_solution() const override;
+
+    /**
+     * @brief Local search of a cooperative thread, return a legal solution better than
+     * the best solution or nothing if the search has been stopped before
+     */
+    std::optional<Solution> cooperative_search(const int thread, Solution &solution);
+
+    /**
+     * @brief Replace the elite of the thread slot if the solution is better
+     */
+    void publish_elite(const int thread, const Solution &solution);
+
+    /**
+     * @brief Replace the solution by the crossover of itself with an elite of another
+     * slot then perturb it
+     */
+    void restart_from_elite(const int thread, Solution &solution);
+
+    /**
+     * @brief Return method header in csv format
+     *
+     * @return std::string method header in csv format
+     */
+    [[nodiscard]] const std::string header_csv() const override;
+
+    /**
+     * @brief Return method in csv format
+     *
+     * @return std::string method in csv format
+     */
+    [[nodiscard]] const std::string line_csv() const override;
+};
@@ -0,0 +1,81 @@
+#include "ReactiveTabu.hpp"
+
+#include <algorithm>
+
+#include "../representation/Graph.hpp"
+
+using namespace graph_instance;
+
+/** @brief log2 of the number of entries of the hash table*/
+constexpr int table_size_bits = 16;
+/** @brief bounds of the factor applied to the tabu tenure*/
+constexpr double min_scale = 1;
+constexpr double max_scale = 20;
+
+ReactiveTabu::ReactiveTabu(const ParamReactive &param)
+    : _param(param),
+      _table(1UL << table_size_bits, Entry{0, 0, 0, 0}),
+      _mask((1UL << table_size_bits) - 1) {}
+
+uint64_t ReactiveTabu::key(const int vertex, const int color) {
+    // splitmix64 finalizer on (vertex, color)
+    uint64_t z = (static_cast<uint64_t>(vertex) << 32) | static_cast<uint32_t>(color + 1);
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void ReactiveTabu::reset(const Solution &solution) {
+    _hash = 0;
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        _hash ^= key(vertex, solution[vertex]);
+    }
+    ++_generation;
+    _last_change = 0;
+    _mean_cycle = 0;
+}
+
+void ReactiveTabu::move(const int vertex, const int old_color, const int new_color) {
+    _hash ^= key(vertex, old_color) ^ key(vertex, new_color);
+}
+
+bool ReactiveTabu::visit(const long turn) {
+    Entry &entry = _table[_hash & _mask];
+    if (entry.generation == _generation and entry.hash == _hash) {
+        // revisit, the tenure is too short
+        const long cycle = turn - entry.turn;
+        entry.turn = turn;
+        ++entry.nb_visits;
+        if (entry.nb_visits > _param.max_repetitions) {
+            return true;
+        }
+        _mean_cycle = 0.1 * static_cast<double>(cycle) + 0.9 * _mean_cycle;
+        _scale = std::min(_scale * _param.increase, max_scale);
+        _last_change = turn;
+        return false;
+    }
+    entry = Entry{_hash, turn, 1, _generation};
+    if (static_cast<double>(turn - _last_change) > _mean_cycle) {
+        // no revisit for a while, the tenure can be shorter
+        _scale = std::max(_scale * _param.decrease, min_scale);
+        _last_change = turn;
+    }
+    return false;
+}
+
+long ReactiveTabu::tenure(const long tenure) const {
+    return static_cast<long>(static_cast<double>(tenure) * _scale);
+}
+
+uint64_t ReactiveTabu::hash() const {
+    return _hash;
+}
+
+bool ReactiveTabu::check_hash(const Solution &solution) const {
+    uint64_t hash = 0;
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        hash ^= key(vertex, solution[vertex]);
+    }
+    return hash == _hash;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../representation/Solution.hpp"
+
+struct ParamReactive {
+    /** @brief factor applied to the tabu tenure when a configuration is revisited*/
+    const double increase;
+    /** @brief factor applied to the tabu tenure when no revisit occurs for a while*/
+    const double decrease;
+    /** @brief number of visits of a same configuration before escaping*/
+    const int max_repetitions;
+    /** @brief number of random moves of an escape*/
+    const int escape_moves;
+};
+
+/**
+ * @brief Reactive tabu tenure
+ *
+ * The coloring is identified by a Zobrist hash, xor of one key for each (vertex, color),
+ * updated in O(1) for each move of a vertex. The recently visited configurations are kept
+ * in a fixed size hash table (a configuration can be overwritten by another one). When a
+ * configuration is revisited, the tabu tenure is lengthened, when no configuration is
+ * revisited for longer than the mean cycle length, the tenure is shortened (never below
+ * the static tenure). When a configuration is visited too many times, the search must
+ * escape with random moves.
+ *
+ * From :
+ * Battiti, Roberto, and Giampietro Tecchiolli.
+ * The Reactive Tabu Search.
+ * ORSA Journal on Computing 6, no. 2 (May 1994): 126–40.
+ * https://doi.org/10.1287/ijoc.6.2.126.
+ */
+class ReactiveTabu {
+
+    /** @brief Configuration in the hash table*/
+    struct Entry {
+        uint64_t hash;
+        /** @brief last turn the configuration was visited*/
+        long turn;
+        int nb_visits;
+        /** @brief entries of older generations are considered empty*/
+        int generation;
+    };
+
+    const ParamReactive _param;
+
+    /** @brief Hash of the current coloring*/
+    uint64_t _hash{0};
+
+    /** @brief Recently visited configurations, indexed by hash & _mask*/
+    std::vector<Entry> _table;
+    uint64_t _mask;
+    int _generation{1};
+
+    /** @brief Factor applied to the tabu tenure*/
+    double _scale{1};
+    /** @brief Last turn the factor was increased or decreased*/
+    long _last_change{0};
+    /** @brief Moving average of the number of turns between two visits*/
+    double _mean_cycle{0};
+
+    /**
+     * @brief Zobrist key of the vertex in the color (-1 for uncolored)
+     */
+    static uint64_t key(const int vertex, const int color);
+
+  public:
+    explicit ReactiveTabu(const ParamReactive &param);
+
+    /**
+     * @brief Compute the hash of the solution and forget the visited configurations
+     */
+    void reset(const Solution &solution);
+
+    /**
+     * @brief Update the hash when the vertex moves from old_color to new_color
+     */
+    void move(const int vertex, const int old_color, const int new_color);
+
+    /**
+     * @brief Record the visit of the current configuration and adapt the tenure
+     *
+     * @return true if the configuration has been visited too many times, the search must
+     * escape
+     */
+    bool visit(const long turn);
+
+    /**
+     * @brief Scale the tabu tenure
+     */
+    long tenure(const long tenure) const;
+
+    /**
+     * @brief Hash of the current coloring
+     */
+    uint64_t hash() const;
+
+    /**
+     * @brief Return true if the hash is the hash of the solution
+     */
+    bool check_hash(const Solution &solution) const;
+};
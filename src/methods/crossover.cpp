@@ -310,3 +310,43 @@ void partial_random_gpx(const Solution &parent1,
         child.add_to_color(vertex, rd::choice(best_colors));
     }
 }
+
+void kempe_perturbation(const Solution &parent1,
+                        const Solution &parent2,
+                        Solution &child,
+                        const ParamCrossover &param) {
+    (void)parent2; // to remove warning "unused parameter"
+    std::vector<std::vector<int>> color_groups(parent1.nb_colors());
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        const int color = parent1[vertex];
+        if (color != -1) {
+            color_groups[color].emplace_back(vertex);
+        }
+    }
+    // copy the partition of parent1 color by color, the classes emptied by a local search
+    // stay empty to keep the number of colors of parent1
+    for (const auto &group : color_groups) {
+        const int color = child.add_empty_color();
+        for (const auto &vertex : group) {
+            child.add_to_color(vertex, color);
+        }
+    }
+    if (child.nb_colors() < 2) {
+        return;
+    }
+    std::uniform_int_distribution<int> distribution_vertices(0, graph->nb_vertices - 1);
+    std::uniform_int_distribution<int> distribution_colors(0, child.nb_colors() - 2);
+    for (int i = 0; i < param.kempe_moves; ++i) {
+        const int vertex = distribution_vertices(rd::generator);
+        if (child[vertex] == -1) {
+            continue;
+        }
+        // random color other than the current one
+        int color = distribution_colors(rd::generator);
+        if (color >= child[vertex]) {
+            ++color;
+        }
+        child.kempe_chain_move(vertex, color);
+    }
+    assert(child.nb_colors() == parent1.nb_colors());
+}
@@ -7,6 +7,8 @@ struct ParamCrossover {
     std::string pseudo;
     int percentage_p1;
     int colors_p1;
+    /** @brief number of Kempe chain interchanges of kempe_perturbation*/
+    int kempe_moves;
 };
 
 typedef void (*crossover_ptr)(const Solution &,
@@ -73,3 +75,18 @@ void partial_random_gpx(const Solution &parent1,
                         const Solution &parent2,
                         Solution &child,
                         const ParamCrossover &param);
+
+/**
+ * @brief Recreate parent1 (does nothing with parent2) in the child then apply kempe_moves
+ * Kempe chain interchanges from random vertices to random colors, the child keeps the
+ * penalty of parent1 in a different area of the search space
+ *
+ * @param parent1 first parent (used)
+ * @param parent2 second parent (unused)
+ * @param child created child
+ * @param param parameters
+ */
+void kempe_perturbation(const Solution &parent1,
+                        const Solution &parent2,
+                        Solution &child,
+                        const ParamCrossover &param);
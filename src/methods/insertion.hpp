@@ -1,6 +1,6 @@
 #pragma once
 
-#include "../representation/Solution.hpp"
+#include "../representation/Population.hpp"
 
 struct ParamInsertion {
     std::string name;
@@ -13,10 +13,10 @@ struct ParamInsertion {
  * the function take in parameter the population, the child and the parameters for the
  * insertion and return the index in the population of the individuals that will be
  * replaced by the child. -1 means that the child is not inserted in the population.
- * The population must be sorted by penalty.
+ * The distances from the child to the population must be computed as candidate.
  *
  */
-typedef int (*insertion_ptr)(const std::vector<Solution> &,
+typedef int (*insertion_ptr)(const Population &,
                              const Solution &,
                              const ParamInsertion &);
 
@@ -26,13 +26,13 @@ struct Insertion {
 
     explicit Insertion(const insertion_ptr function_, const ParamInsertion &param_);
 
-    int run(const std::vector<Solution> &population, const Solution &child) const;
+    int run(const Population &population, const Solution &child) const;
 };
 
-int insertion_best(const std::vector<Solution> &population,
+int insertion_best(const Population &population,
                    const Solution &child,
                    const ParamInsertion &param);
 
-int insertion_distance(const std::vector<Solution> &population,
+int insertion_distance(const Population &population,
                        const Solution &child,
                        const ParamInsertion &param);
@@ -9,22 +9,26 @@
 using namespace parameters_search;
 
 Selection::Selection(const selection_ptr function_, const ParamSelection &param_)
-    : function(function_), param(param_) {
+    : function(function_), param(param_), param_single{param_.name, 1} {
 }
 
 std::vector<std::pair<int, int>>
-Selection::run(const std::vector<Solution> &population) const {
+Selection::run(const Population &population) const {
     return function(population, param);
 }
 
-std::vector<std::pair<int, int>> selection_random(const std::vector<Solution> &population,
+std::pair<int, int> Selection::run_single(const Population &population) const {
+    return function(population, param_single).front();
+}
+
+std::vector<std::pair<int, int>> selection_random(const Population &population,
                                                   const ParamSelection &param) {
     std::vector<std::pair<int, int>> selected;
     selected.reserve(param.nb_selected);
 
     // select the fists parents randomly
     std::set<int> firsts_parents;
-    std::uniform_int_distribution<int> dist(0, static_cast<int>(population.size()) - 1);
+    std::uniform_int_distribution<int> dist(0, population.size() - 1);
 
     while (static_cast<int>(firsts_parents.size()) != param.nb_selected) {
         firsts_parents.insert(dist(rd::generator));
@@ -35,15 +39,15 @@ std::vector<std::pair<int, int>> selection_random(const std::vector<Solution> &p
         int second_parent;
         do {
             second_parent = dist(rd::generator);
-        } while (first_parent == second_parent or population[first_parent].distances.at(
-                                                      population[second_parent].id) == 0);
+        } while (first_parent == second_parent or
+                 population.distance(first_parent, second_parent) == 0);
         selected.push_back(std::make_pair(first_parent, second_parent));
     }
     return selected;
 }
 
 std::vector<std::pair<int, int>>
-selection_random_closest(const std::vector<Solution> &population,
+selection_random_closest(const Population &population,
                          const ParamSelection &param) {
 
     std::vector<std::pair<int, int>> selected;
@@ -51,7 +55,7 @@ selection_random_closest(const std::vector<Solution> &population,
 
     // select the fists parents randomly
     std::set<int> firsts_parents;
-    std::uniform_int_distribution<int> dist(0, static_cast<int>(population.size()) - 1);
+    std::uniform_int_distribution<int> dist(0, population.size() - 1);
 
     while (static_cast<int>(firsts_parents.size()) != param.nb_selected) {
         firsts_parents.insert(dist(rd::generator));
@@ -63,15 +67,14 @@ selection_random_closest(const std::vector<Solution> &population,
         // closer parent selection
         std::vector<std::tuple<int, int>> seconds_parents;
         for (int second_parent_rank = 0;
-             second_parent_rank < static_cast<int>(population.size());
+             second_parent_rank < population.size();
              ++second_parent_rank) {
             if (first_parent == second_parent_rank) {
                 continue;
             }
-            const auto second_parent_id = population[second_parent_rank].id;
             seconds_parents.emplace_back(
                 second_parent_rank,
-                population[first_parent].distances.at(second_parent_id));
+                population.distance(first_parent, second_parent_rank));
         }
         // sort the possible seconds parents per distance
         std::stable_sort(seconds_parents.begin(),
@@ -89,7 +92,7 @@ selection_random_closest(const std::vector<Solution> &population,
 }
 
 std::vector<std::pair<int, int>>
-selection_elitist(const std::vector<Solution> &population, const ParamSelection &param) {
+selection_elitist(const Population &population, const ParamSelection &param) {
     std::vector<std::pair<int, int>> selected;
     selected.reserve(param.nb_selected);
 
@@ -104,11 +107,10 @@ selection_elitist(const std::vector<Solution> &population, const ParamSelection
     for (const auto &first_parent : firsts_parents) {
         int second_parent;
         for (int second_parent_rank = 0;
-             second_parent_rank < static_cast<int>(population.size());
+             second_parent_rank < population.size();
              ++second_parent_rank) {
             if (first_parent == second_parent_rank or
-                population[first_parent].distances.at(
-                    population[second_parent_rank].id) == 0) {
+                population.distance(first_parent, second_parent_rank) == 0) {
                 continue;
             } else {
                 second_parent = second_parent_rank;
@@ -120,7 +122,7 @@ selection_elitist(const std::vector<Solution> &population, const ParamSelection
     return selected;
 }
 
-std::vector<std::pair<int, int>> selection_head(const std::vector<Solution> &population,
+std::vector<std::pair<int, int>> selection_head(const Population &population,
                                                 const ParamSelection &param) {
     (void)population;
     (void)param;
@@ -1,33 +1,40 @@
 #pragma once
 
-#include "../representation/Solution.hpp"
+#include "../representation/Population.hpp"
 
 struct ParamSelection {
     std::string name;
     int nb_selected;
 };
 
-typedef std::vector<std::pair<int, int>> (*selection_ptr)(const std::vector<Solution> &,
+typedef std::vector<std::pair<int, int>> (*selection_ptr)(const Population &,
                                                           const ParamSelection &);
 
 struct Selection {
     const selection_ptr function;
     const ParamSelection param;
+    /** @brief same parameters with one pair selected*/
+    const ParamSelection param_single;
 
     explicit Selection(const selection_ptr function_, const ParamSelection &param_);
 
-    std::vector<std::pair<int, int>> run(const std::vector<Solution> &population) const;
+    std::vector<std::pair<int, int>> run(const Population &population) const;
+
+    /**
+     * @brief Select a single pair of parents (steady state)
+     */
+    std::pair<int, int> run_single(const Population &population) const;
 };
 
-std::vector<std::pair<int, int>> selection_random(const std::vector<Solution> &population,
+std::vector<std::pair<int, int>> selection_random(const Population &population,
                                                   const ParamSelection &param);
 
 std::vector<std::pair<int, int>>
-selection_random_closest(const std::vector<Solution> &population,
+selection_random_closest(const Population &population,
                          const ParamSelection &param);
 
 std::vector<std::pair<int, int>>
-selection_elitist(const std::vector<Solution> &population, const ParamSelection &param);
+selection_elitist(const Population &population, const ParamSelection &param);
 
-std::vector<std::pair<int, int>> selection_head(const std::vector<Solution> &population,
+std::vector<std::pair<int, int>> selection_head(const Population &population,
                                                 const ParamSelection &param);
@@ -17,6 +17,45 @@ std::unique_ptr<const Graph> graph;
 std::unique_ptr<const QGraph> qgraph;
 } // namespace graph_instance
 
+namespace {
+/**
+ * @brief For each vertex, the index of the edge to each of its neighbors
+ */
+std::vector<std::vector<int>>
+number_edges(const std::vector<std::vector<int>> &neighborhood) {
+    const int nb_vertices = static_cast<int>(neighborhood.size());
+    std::vector<std::vector<int>> indices(nb_vertices);
+    // the edges to the greater neighbors are numbered first, then each vertex reads the
+    // index of the edges to its smaller neighbors
+    std::vector<std::vector<std::pair<int, int>>> smaller(nb_vertices);
+    int nb_edges = 0;
+    for (int vertex = 0; vertex < nb_vertices; ++vertex) {
+        indices[vertex].resize(neighborhood[vertex].size(), -1);
+        for (size_t i = 0; i < neighborhood[vertex].size(); ++i) {
+            const int neighbor = neighborhood[vertex][i];
+            if (vertex < neighbor) {
+                indices[vertex][i] = nb_edges;
+                smaller[neighbor].emplace_back(vertex, nb_edges);
+                ++nb_edges;
+            }
+        }
+    }
+    std::vector<int> index(nb_vertices, -1);
+    for (int vertex = 0; vertex < nb_vertices; ++vertex) {
+        for (const auto &[neighbor, edge] : smaller[vertex]) {
+            index[neighbor] = edge;
+        }
+        for (size_t i = 0; i < neighborhood[vertex].size(); ++i) {
+            const int neighbor = neighborhood[vertex][i];
+            if (neighbor < vertex) {
+                indices[vertex][i] = index[neighbor];
+            }
+        }
+    }
+    return indices;
+}
+} // namespace
+
 Graph::Graph(const std::string &name_,
              const int nb_vertices_,
              const int nb_edges_,
@@ -30,7 +69,8 @@ Graph::Graph(const std::string &name_,
       adjacency_matrix(adjacency_matrix_),
       neighborhood(neighborhood_),
       degrees(degrees_),
-      edges_list(edge_lists_) {
+      edges_list(edge_lists_),
+      edge_indices(number_edges(neighborhood_)) {
 }
 
 void load_graph(const std::string &instance_name) {
@@ -31,6 +31,11 @@ struct Graph {
     /** @brief List of edges*/
     const std::vector<std::pair<int, int>> edges_list;
 
+    /** @brief For each vertex, the index of the edge to each of its neighbors (in the
+     * order of neighborhood), computed with the graph so a graph built during the search
+     * has its own indices*/
+    const std::vector<std::vector<int>> edge_indices;
+
     explicit Graph(const std::string &name_,
                    const int nb_vertices_,
                    const int nb_edges_,
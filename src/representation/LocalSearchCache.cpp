@@ -0,0 +1,67 @@
+#include "LocalSearchCache.hpp"
+
+#include <iterator>
+
+LocalSearchCache::LocalSearchCache(const int capacity) : _capacity(capacity) {
+    _positions.reserve(_capacity);
+}
+
+uint64_t LocalSearchCache::key(const uint64_t fingerprint, const int local_search) {
+    return fingerprint ^
+           (static_cast<uint64_t>(local_search + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+bool LocalSearchCache::enabled() const {
+    return _capacity > 0;
+}
+
+bool LocalSearchCache::find(const uint64_t fingerprint,
+                            const int local_search,
+                            Solution &result) {
+    ++_nb_lookups;
+    const auto position = _positions.find(key(fingerprint, local_search));
+    if (position == _positions.end() or position->second->fingerprint != fingerprint or
+        position->second->local_search != local_search) {
+        return false;
+    }
+    ++_nb_hits;
+    // the result becomes the most recently used
+    _entries.splice(_entries.begin(), _entries, position->second);
+    result = _entries.front().result;
+    return true;
+}
+
+void LocalSearchCache::store(const uint64_t fingerprint,
+                             const int local_search,
+                             const Solution &result) {
+    if (not enabled()) {
+        return;
+    }
+    const uint64_t new_key = key(fingerprint, local_search);
+    auto position = _positions.find(new_key);
+    if (position != _positions.end()) {
+        // same key (the child was given twice to the local search in a generation)
+        _entries.splice(_entries.begin(), _entries, position->second);
+    } else if (static_cast<int>(_entries.size()) < _capacity) {
+        _entries.emplace_front(Entry{fingerprint, local_search, Solution()});
+        _positions.emplace(new_key, _entries.begin());
+    } else {
+        // the least recently used entry gets the new result
+        _entries.splice(_entries.begin(), _entries, std::prev(_entries.end()));
+        const Entry &evicted = _entries.front();
+        _positions.erase(key(evicted.fingerprint, evicted.local_search));
+        _positions.emplace(new_key, _entries.begin());
+    }
+    Entry &entry = _entries.front();
+    entry.fingerprint = fingerprint;
+    entry.local_search = local_search;
+    entry.result = result;
+}
+
+long LocalSearchCache::nb_lookups() const {
+    return _nb_lookups;
+}
+
+long LocalSearchCache::nb_hits() const {
+    return _nb_hits;
+}
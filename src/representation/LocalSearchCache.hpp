@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "Solution.hpp"
+
+/**
+ * @brief Bounded cache of the results of the local searches, from the fingerprint of the
+ * child given to the local search and the index of the local search to the solution it
+ * returned
+ *
+ * The least recently used result is evicted when the cache is full, its solution is
+ * reused for the new result. A capacity of 0 disables the cache.
+ */
+class LocalSearchCache {
+
+    struct Entry {
+        uint64_t fingerprint;
+        int local_search;
+        Solution result;
+    };
+
+    /** @brief maximum number of results*/
+    int _capacity;
+    /** @brief results from the most recently used to the least recently used*/
+    std::list<Entry> _entries{};
+    /** @brief position of the result of each key*/
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> _positions{};
+    /** @brief number of calls to find and number of results found*/
+    long _nb_lookups{0};
+    long _nb_hits{0};
+
+    /**
+     * @brief Key of the fingerprint and the local search in the map
+     */
+    static uint64_t key(const uint64_t fingerprint, const int local_search);
+
+  public:
+    explicit LocalSearchCache(const int capacity = 0);
+
+    bool enabled() const;
+
+    /**
+     * @brief Copy in result the result of the local search on the child of the
+     * fingerprint, return false if it is not in the cache
+     */
+    bool find(const uint64_t fingerprint, const int local_search, Solution &result);
+
+    /**
+     * @brief Keep the result of the local search on the child of the fingerprint
+     */
+    void store(const uint64_t fingerprint,
+               const int local_search,
+               const Solution &result);
+
+    long nb_lookups() const;
+    long nb_hits() const;
+};
@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "Solution.hpp"
+
 /**
  * @brief Representation of a method of an algorithm to solve problem
  *
@@ -18,6 +20,11 @@ class Method {
      */
     virtual void run() = 0;
 
+    /**
+     * @brief Return the best solution found by the method
+     */
+    [[nodiscard]] virtual const Solution &best_solution() const = 0;
+
     /**
      * @brief Return method header in csv format
      *
@@ -11,7 +11,9 @@
  */
 struct Parameters {
 
-    const int nb_colors;
+    /** @brief number of colors, lowered while a method runs on a residual graph after
+     * the extraction of color classes*/
+    int nb_colors;
     const bool use_target;
     const int rand_seed;
     const std::chrono::high_resolution_clock::time_point time_start;
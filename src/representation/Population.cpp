@@ -0,0 +1,318 @@
+#include "Population.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+#include "Graph.hpp"
+
+using namespace graph_instance;
+
+void PopulationSnapshot::compute_candidate(const Solution &candidate) {
+    distances.resize(colors.size());
+    for (size_t slot = 0; slot < colors.size(); ++slot) {
+        distances[slot] = distance_accurate(candidate.colors(), colors[slot]);
+    }
+    fingerprint = candidate.fingerprint();
+}
+
+Population::Population(const int size)
+    : _individuals(size),
+      _order(size),
+      _penalties(size, 0),
+      _size(size),
+      _distances((size + 1) * size, 0),
+      _row_min(size, 0),
+      _row_max(size, 0),
+      _sum_distances(0),
+      _fingerprints(size, 0),
+      _versions(size, 0) {
+    std::iota(_order.begin(), _order.end(), 0);
+}
+
+void Population::update_row(const int slot) {
+    int row_min = std::numeric_limits<int>::max();
+    int row_max = 0;
+    for (int other = 0; other < _size; ++other) {
+        if (other == slot) {
+            continue;
+        }
+        row_min = std::min(row_min, _distances[slot * _size + other]);
+        row_max = std::max(row_max, _distances[slot * _size + other]);
+    }
+    _row_min[slot] = row_min;
+    _row_max[slot] = row_max;
+}
+
+void Population::reset(std::vector<Solution> &individuals) {
+    assert(static_cast<int>(individuals.size()) == _size);
+    _individuals.swap(individuals);
+    _nb_fingerprints.clear();
+    for (int slot = 0; slot < _size; ++slot) {
+        _penalties[slot] = _individuals[slot].penalty();
+        _fingerprints[slot] = _individuals[slot].fingerprint();
+        ++_nb_fingerprints[_fingerprints[slot]];
+        _versions[slot] = ++_version;
+    }
+    std::iota(_order.begin(), _order.end(), 0);
+    std::stable_sort(_order.begin(), _order.end(), [&](const int slot1, const int slot2) {
+        return _penalties[slot1] < _penalties[slot2];
+    });
+    _sum_distances = 0;
+    for (int slot1 = 0; slot1 < _size; ++slot1) {
+        for (int slot2 = slot1 + 1; slot2 < _size; ++slot2) {
+            const int dist = distance_accurate(_individuals[slot1], _individuals[slot2]);
+            _distances[slot1 * _size + slot2] = dist;
+            _distances[slot2 * _size + slot1] = dist;
+            _sum_distances += dist;
+        }
+    }
+    for (int slot = 0; slot < _size; ++slot) {
+        update_row(slot);
+    }
+    assert(check_distances());
+}
+
+int Population::size() const {
+    return _size;
+}
+
+const Solution &Population::operator[](const int rank) const {
+    return _individuals[_order[rank]];
+}
+
+const Solution &Population::back() const {
+    return _individuals[_order.back()];
+}
+
+void Population::increment_ages() {
+    for (auto &individual : _individuals) {
+        ++individual.age;
+    }
+}
+
+int Population::distance(const int rank1, const int rank2) const {
+    return _distances[_order[rank1] * _size + _order[rank2]];
+}
+
+int Population::min_distance(const int rank) const {
+    return _row_min[_order[rank]];
+}
+
+void Population::compute_candidate(const Solution &candidate) {
+    int *row = &_distances[_size * _size];
+#pragma omp parallel for
+    for (int slot = 0; slot < _size; ++slot) {
+        row[slot] = distance_accurate(candidate, _individuals[slot]);
+    }
+    _candidate_fingerprint = candidate.fingerprint();
+    _candidate = -1;
+}
+
+void Population::update_snapshot(PopulationSnapshot &snapshot) const {
+    snapshot.colors.resize(_size);
+    snapshot.versions.resize(_size, -1);
+    for (int slot = 0; slot < _size; ++slot) {
+        if (snapshot.versions[slot] != _versions[slot]) {
+            snapshot.colors[slot] = _individuals[slot].colors();
+            snapshot.versions[slot] = _versions[slot];
+        }
+    }
+}
+
+void Population::compute_candidate(const PopulationSnapshot &snapshot,
+                                   const Solution &candidate) {
+    assert(static_cast<int>(snapshot.distances.size()) == _size);
+    int *row = &_distances[_size * _size];
+    for (int slot = 0; slot < _size; ++slot) {
+        row[slot] = snapshot.versions[slot] == _versions[slot]
+                        ? snapshot.distances[slot]
+                        : distance_accurate(candidate, _individuals[slot]);
+    }
+    _candidate_fingerprint = snapshot.fingerprint;
+    _candidate = -1;
+}
+
+void Population::compute_candidates(const std::vector<Solution> &candidates) {
+    _nb_candidates = static_cast<int>(candidates.size());
+    _candidates_distances.resize(_nb_candidates * _size);
+    _between_candidates.assign(_nb_candidates * _nb_candidates, 0);
+    _candidates_fingerprints.resize(_nb_candidates);
+    // one kernel for the nb_candidates x size block and the pairs of candidates
+    const int nb_pairs = _nb_candidates * _size;
+    const int nb_distances = nb_pairs + _nb_candidates * _nb_candidates;
+#pragma omp parallel for schedule(dynamic)
+    for (int index = 0; index < nb_distances; ++index) {
+        if (index < nb_pairs) {
+            if (index % _size == 0) {
+                _candidates_fingerprints[index / _size] =
+                    candidates[index / _size].fingerprint();
+            }
+            _candidates_distances[index] = distance_accurate(
+                candidates[index / _size], _individuals[index % _size]);
+            continue;
+        }
+        const int candidate1 = (index - nb_pairs) / _nb_candidates;
+        const int candidate2 = (index - nb_pairs) % _nb_candidates;
+        if (candidate1 < candidate2) {
+            const int dist =
+                distance_accurate(candidates[candidate1], candidates[candidate2]);
+            _between_candidates[candidate1 * _nb_candidates + candidate2] = dist;
+            _between_candidates[candidate2 * _nb_candidates + candidate1] = dist;
+        }
+    }
+    _candidate = -1;
+}
+
+void Population::select_candidate(const int candidate) {
+    assert(candidate >= 0 and candidate < _nb_candidates);
+    std::copy_n(_candidates_distances.begin() + candidate * _size,
+                _size,
+                _distances.begin() + _size * _size);
+    _candidate_fingerprint = _candidates_fingerprints[candidate];
+    _candidate = candidate;
+}
+
+int Population::candidate_distance(const int rank) const {
+    return _distances[_size * _size + _order[rank]];
+}
+
+uint64_t Population::candidate_fingerprint() const {
+    return _candidate_fingerprint;
+}
+
+void Population::replace(const int rank, const Solution &candidate) {
+    _individuals[_order[rank]] = candidate;
+    update_slot(rank);
+}
+
+void Population::swap_in(const int rank, Solution &candidate) {
+    std::swap(_individuals[_order[rank]], candidate);
+    update_slot(rank);
+}
+
+void Population::update_slot(const int rank) {
+    const int slot = _order[rank];
+    const int *row = &_distances[_size * _size];
+    for (int other = 0; other < _size; ++other) {
+        if (other == slot) {
+            continue;
+        }
+        const int old_dist = _distances[other * _size + slot];
+        const int new_dist = row[other];
+        _distances[other * _size + slot] = new_dist;
+        _distances[slot * _size + other] = new_dist;
+        _sum_distances += new_dist - old_dist;
+        // the row of the other individual is computed again only if it lost its minimum
+        // or its maximum
+        if ((old_dist == _row_min[other] and new_dist > old_dist) or
+            (old_dist == _row_max[other] and new_dist < old_dist)) {
+            update_row(other);
+        } else {
+            _row_min[other] = std::min(_row_min[other], new_dist);
+            _row_max[other] = std::max(_row_max[other], new_dist);
+        }
+    }
+    update_row(slot);
+    if (_candidate != -1) {
+        // the other candidates of the batch see the candidate in the slot
+        for (int other = 0; other < _nb_candidates; ++other) {
+            _candidates_distances[other * _size + slot] =
+                _between_candidates[other * _nb_candidates + _candidate];
+        }
+    }
+
+    // move the slot to its rank, after the individuals of same penalty, only the ranks
+    // between the old and the new one are shifted
+    const int penalty = _individuals[slot].penalty();
+    _penalties[slot] = penalty;
+    const auto old_fingerprint = _nb_fingerprints.find(_fingerprints[slot]);
+    if (--old_fingerprint->second == 0) {
+        _nb_fingerprints.erase(old_fingerprint);
+    }
+    _fingerprints[slot] = _candidate_fingerprint;
+    ++_nb_fingerprints[_fingerprints[slot]];
+    _versions[slot] = ++_version;
+    const auto by_penalty = [&](const int value, const int other) {
+        return value < _penalties[other];
+    };
+    const auto current = _order.begin() + rank;
+    if (rank > 0 and penalty < _penalties[*(current - 1)]) {
+        const auto position =
+            std::upper_bound(_order.begin(), current, penalty, by_penalty);
+        std::rotate(position, current, current + 1);
+    } else {
+        const auto position =
+            std::upper_bound(current + 1, _order.end(), penalty, by_penalty);
+        std::rotate(current, current + 1, position);
+    }
+    assert(check_distances());
+}
+
+bool Population::contains(const uint64_t fingerprint) const {
+    return _nb_fingerprints.count(fingerprint) != 0;
+}
+
+int Population::min_distance() const {
+    if (_size < 2) {
+        return graph->nb_vertices;
+    }
+    return *std::min_element(_row_min.begin(), _row_min.end());
+}
+
+double Population::mean_distance() const {
+    if (_size < 2) {
+        return 0;
+    }
+    return static_cast<double>(_sum_distances) / (_size * (_size - 1) / 2);
+}
+
+int Population::max_distance() const {
+    if (_size < 2) {
+        return 0;
+    }
+    return *std::max_element(_row_max.begin(), _row_max.end());
+}
+
+bool Population::check_distances() const {
+    long sum_distances = 0;
+    for (int slot1 = 0; slot1 < _size; ++slot1) {
+        int row_min = std::numeric_limits<int>::max();
+        int row_max = 0;
+        for (int slot2 = 0; slot2 < _size; ++slot2) {
+            if (slot1 == slot2) {
+                continue;
+            }
+            const int dist = distance_accurate(_individuals[slot1], _individuals[slot2]);
+            if (_distances[slot1 * _size + slot2] != dist) {
+                return false;
+            }
+            row_min = std::min(row_min, dist);
+            row_max = std::max(row_max, dist);
+            if (slot1 < slot2) {
+                sum_distances += dist;
+            }
+        }
+        if (_row_min[slot1] != row_min or _row_max[slot1] != row_max) {
+            return false;
+        }
+    }
+    std::unordered_map<uint64_t, int> nb_fingerprints;
+    for (int slot = 0; slot < _size; ++slot) {
+        if (_penalties[slot] != _individuals[slot].penalty() or
+            _fingerprints[slot] != _individuals[slot].fingerprint()) {
+            return false;
+        }
+        ++nb_fingerprints[_fingerprints[slot]];
+    }
+    if (nb_fingerprints != _nb_fingerprints) {
+        return false;
+    }
+    for (int rank = 1; rank < _size; ++rank) {
+        if ((*this)[rank - 1].penalty() > (*this)[rank].penalty()) {
+            return false;
+        }
+    }
+    return sum_distances == _sum_distances;
+}
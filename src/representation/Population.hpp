@@ -0,0 +1,213 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "Solution.hpp"
+
+/**
+ * @brief Copy of the colors of the individuals of a population, to compute the distances
+ * of a candidate without reading the population (out of its lock), the individual of a
+ * slot is copied again only when it changed since the last copy
+ */
+struct PopulationSnapshot {
+    /** @brief for each slot, colors of the individual when copied*/
+    std::vector<std::vector<int>> colors{};
+    /** @brief for each slot, version of the individual when copied, -1 before the first
+     * copy*/
+    std::vector<long> versions{};
+    /** @brief distances from the candidate to the copied individuals*/
+    std::vector<int> distances{};
+    /** @brief fingerprint of the candidate*/
+    uint64_t fingerprint{0};
+
+    /**
+     * @brief Compute the distances from the candidate to the copied individuals and its
+     * fingerprint
+     */
+    void compute_candidate(const Solution &candidate);
+};
+
+/**
+ * @brief Population of a memetic algorithm with the distances between its individuals
+ *
+ * The individuals stay in their slot, the ranks give the individuals sorted by penalty
+ * (stable) and a replaced individual only moves its slot id to its new rank by binary
+ * search, no Solution is moved to keep the order. The distances are kept in a flat
+ * size x size matrix indexed by slots, plus a scratch row for the distances of a
+ * candidate to the individuals. Replacing an individual by the candidate copies the
+ * scratch row in O(size) and updates the minimum and maximum distance of each row and
+ * the sum of the distances.
+ *
+ * The distances of a batch of candidates (the children of a generation) are computed
+ * at once in parallel, to the individuals and between the candidates, so the rows of the
+ * candidates stay valid when one of them replaces an individual.
+ *
+ * The fingerprints of the individuals are counted in a hash map to know in O(1) if a
+ * solution is already in the population.
+ *
+ * Each slot has the version of the population when its individual was last replaced, a
+ * PopulationSnapshot only copies the slots of a newer version and the distances computed
+ * on a snapshot are only computed again for the slots replaced since the copy.
+ */
+class Population {
+
+    /** @brief individuals by slot*/
+    std::vector<Solution> _individuals;
+    /** @brief for each rank, the slot of the individual*/
+    std::vector<int> _order;
+    /** @brief for each slot, the penalty of the individual (the binary searches do not
+     * read the solutions)*/
+    std::vector<int> _penalties;
+    /** @brief number of individuals*/
+    int _size;
+    /** @brief distance between the individuals of slots i and j at i * size + j, the
+     * scratch row of the candidate at size * size*/
+    std::vector<int> _distances;
+    /** @brief for each slot, minimum and maximum distance to the other individuals*/
+    std::vector<int> _row_min;
+    std::vector<int> _row_max;
+    /** @brief sum of the distances between each pair of individuals*/
+    long _sum_distances;
+    /** @brief for each slot, fingerprint of the individual*/
+    std::vector<uint64_t> _fingerprints;
+    /** @brief number of individuals of each fingerprint*/
+    std::unordered_map<uint64_t, int> _nb_fingerprints{};
+    /** @brief for each slot, version of the population when its individual was set*/
+    std::vector<long> _versions;
+    /** @brief incremented at each replaced individual*/
+    long _version{0};
+
+    /** @brief number of candidates of the batch*/
+    int _nb_candidates{0};
+    /** @brief distance between the candidate c and the individual of slot i at
+     * c * size + i*/
+    std::vector<int> _candidates_distances{};
+    /** @brief distance between the candidates c1 and c2 at c1 * nb_candidates + c2*/
+    std::vector<int> _between_candidates{};
+    /** @brief fingerprint of each candidate of the batch*/
+    std::vector<uint64_t> _candidates_fingerprints{};
+    /** @brief fingerprint of the candidate in the scratch row*/
+    uint64_t _candidate_fingerprint{0};
+    /** @brief candidate of the batch in the scratch row, -1 for a candidate outside of
+     * the batch*/
+    int _candidate{-1};
+
+    /**
+     * @brief Compute the minimum and maximum distance of the row of the slot
+     */
+    void update_row(const int slot);
+
+    /**
+     * @brief Update the distances and the rank of the slot of the rank, which just
+     * received the last candidate
+     */
+    void update_slot(const int rank);
+
+  public:
+    explicit Population(const int size = 0);
+
+    /**
+     * @brief Replace all the individuals by swapping them with the given ones (which get
+     * the former individuals, to reuse their buffers), sort them by penalty and compute
+     * all the distances
+     */
+    void reset(std::vector<Solution> &individuals);
+
+    int size() const;
+
+    /**
+     * @brief Individual of the rank (0 for the lowest penalty)
+     */
+    const Solution &operator[](const int rank) const;
+
+    /**
+     * @brief Individual with the highest penalty
+     */
+    const Solution &back() const;
+
+    /**
+     * @brief Increment the age of each individual
+     */
+    void increment_ages();
+
+    /**
+     * @brief Distance between the individuals of the ranks
+     */
+    int distance(const int rank1, const int rank2) const;
+
+    /**
+     * @brief Minimum distance between the individual of the rank and the other ones
+     */
+    int min_distance(const int rank) const;
+
+    /**
+     * @brief Compute in parallel the distances from the candidate to the individuals in
+     * the scratch row
+     */
+    void compute_candidate(const Solution &candidate);
+
+    /**
+     * @brief Copy in the snapshot the individuals replaced since its last copy
+     */
+    void update_snapshot(PopulationSnapshot &snapshot) const;
+
+    /**
+     * @brief Copy the distances of the candidate computed on the snapshot in the scratch
+     * row, the distances to the individuals replaced since the snapshot are computed
+     * again
+     */
+    void compute_candidate(const PopulationSnapshot &snapshot, const Solution &candidate);
+
+    /**
+     * @brief Compute in parallel the distances from each candidate to the individuals and
+     * between the candidates
+     */
+    void compute_candidates(const std::vector<Solution> &candidates);
+
+    /**
+     * @brief Copy the distances of the candidate of the last batch in the scratch row
+     */
+    void select_candidate(const int candidate);
+
+    /**
+     * @brief Distance between the last candidate and the individual of the rank
+     */
+    int candidate_distance(const int rank) const;
+
+    /**
+     * @brief Fingerprint of the last candidate
+     */
+    uint64_t candidate_fingerprint() const;
+
+    /**
+     * @brief Replace the individual of the rank by the last candidate, which is sorted in
+     * after the individuals of same penalty, the distances of the other candidates of the
+     * batch to the slot are updated
+     */
+    void replace(const int rank, const Solution &candidate);
+
+    /**
+     * @brief Replace the individual of the rank by the last candidate without copy, the
+     * candidate gets the replaced individual (to reuse its buffers)
+     */
+    void swap_in(const int rank, Solution &candidate);
+
+    /**
+     * @brief Return true if an individual has the fingerprint
+     */
+    bool contains(const uint64_t fingerprint) const;
+
+    /**
+     * @brief Minimum, mean and maximum distance between two individuals
+     */
+    int min_distance() const;
+    double mean_distance() const;
+    int max_distance() const;
+
+    /**
+     * @brief Check the distances, their row minimum and maximum and their sum, the
+     * penalties and the fingerprints against the individuals
+     */
+    bool check_distances() const;
+};
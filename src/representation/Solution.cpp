@@ -21,14 +21,37 @@
 using namespace graph_instance;
 using namespace parameters_search;
 
-int Solution::best_penalty = std::numeric_limits<int>::max();
-int Solution::best_nb_colors = std::numeric_limits<int>::max();
+std::atomic<int> Solution::best_penalty{std::numeric_limits<int>::max()};
+std::atomic<int> Solution::best_nb_colors{std::numeric_limits<int>::max()};
 
-ulong Solution::counter = 0;
+std::atomic<ulong> Solution::counter{0};
 const std::string Solution::header_csv = "nb_uncolored,penalty,nb_colors,solution";
 
+/**
+ * @brief Lower the atomic best to the value if it is better, the new best is published
+ * with release ordering
+ */
+static bool atomic_min(std::atomic<int> &best, const int value) {
+    int current = best.load(std::memory_order_relaxed);
+    while (value < current) {
+        if (best.compare_exchange_weak(
+                current, value, std::memory_order_release, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Solution::update_best_penalty(const int penalty) {
+    return atomic_min(best_penalty, penalty);
+}
+
+bool Solution::update_best_nb_colors(const int nb_colors) {
+    return atomic_min(best_nb_colors, nb_colors);
+}
+
 Solution::Solution()
-    : id(counter++),
+    : id(counter.fetch_add(1, std::memory_order_relaxed)),
       _colors(graph->nb_vertices, -1),
       _nb_colors(0),
       _uncolored(graph->nb_vertices),
@@ -36,8 +59,44 @@ Solution::Solution()
     std::iota(_uncolored.begin(), _uncolored.end(), 0);
 }
 
+void Solution::reset() {
+    id = counter.fetch_add(1, std::memory_order_relaxed);
+    age = 0;
+    std::fill(_colors.begin(), _colors.end(), -1);
+    _nb_colors = 0;
+    _uncolored.resize(graph->nb_vertices);
+    std::iota(_uncolored.begin(), _uncolored.end(), 0);
+    _penalty = 0;
+    _color_size.clear();
+    for (auto &row : _conflicts) {
+        _spare_conflicts.emplace_back(std::move(row));
+    }
+    _conflicts.clear();
+    _conflicting_vertices.clear();
+    // the structures of the local searches are built again by their init
+    _free_vertices.clear();
+    _free_vertices_position.clear();
+    _nb_free_neighbors.clear();
+    _deltas.clear();
+    _best_delta.clear();
+    _best_improve_colors.clear();
+    _deltas_up_to_date = false;
+    _edge_weights.clear();
+    _weighted_conflicts.clear();
+    _weighted_penalty = 0;
+    _possible_colors.clear();
+    _first_free_vertex = 0;
+    _grenade_stack.clear();
+    _kempe_chain.clear();
+    _kempe_color_1 = -1;
+    _kempe_color_2 = -1;
+}
+
 Solution::Solution(const std::vector<std::vector<int>> &solution)
-    : _colors(graph->nb_vertices, -1), _nb_colors(0), _penalty(0) {
+    : id(counter.fetch_add(1, std::memory_order_relaxed)),
+      _colors(graph->nb_vertices, -1),
+      _nb_colors(0),
+      _penalty(0) {
     for (const auto &group : solution) {
         int color = -1;
         for (const auto vertex : group) {
@@ -66,12 +125,15 @@ Solution::Solution(const std::vector<std::vector<int>> &solution)
 }
 
 Solution::Solution(const std::vector<bool> &solution)
-    : _colors(graph->nb_vertices, -1),
+    : id(counter.fetch_add(1, std::memory_order_relaxed)),
+      _colors(graph->nb_vertices, -1),
       _nb_colors(0),
       _uncolored(graph->nb_vertices),
       _penalty(0) {
     std::iota(_uncolored.begin(), _uncolored.end(), 0);
     std::vector<int> dominants(graph->nb_vertices, -1);
+    // for each dominant, the index of its group
+    std::vector<int> dominant_groups(graph->nb_vertices, -1);
     std::vector<std::vector<int>> color_groups;
     // color_groups.reserve(nb_max_colors);
 
@@ -98,6 +160,7 @@ Solution::Solution(const std::vector<bool> &solution)
             // the tail become the dominant of a new color
             dominants[tail] = tail;
             dominants[head] = tail;
+            dominant_groups[tail] = nb_colors;
             color_groups.emplace_back();
             color_groups[nb_colors].emplace_back(tail);
             color_groups[nb_colors].emplace_back(head);
@@ -105,24 +168,14 @@ Solution::Solution(const std::vector<bool> &solution)
         } else if (dominants[tail] == -1) {
             // if the head already in a color
             // the tail join the color
-            int color_ = -1;
-            for (int color = 0; color < nb_colors; ++color) {
-                if (color_groups[color][0] == dominants[head]) {
-                    color_ = color;
-                }
-            }
+            const int color_ = dominant_groups[dominants[head]];
             assert(color_ != -1);
             dominants[tail] = dominants[head];
             color_groups[color_].emplace_back(tail);
         } else if (dominants[head] == -1) {
             // if the tail already in a color
             // the head join the color
-            int color_ = -1;
-            for (int color = 0; color < nb_colors; ++color) {
-                if (color_groups[color][0] == dominants[tail]) {
-                    color_ = color;
-                }
-            }
+            const int color_ = dominant_groups[dominants[tail]];
             assert(color_ != -1);
             dominants[head] = dominants[tail];
             color_groups[color_].emplace_back(head);
@@ -228,6 +281,7 @@ Solution Solution::reduce_nb_colors_illegal(const int nb_colors) const {
 }
 
 void Solution::init_deltas() {
+    _deltas_up_to_date = false;
     _deltas = std::vector<std::vector<int>>(_nb_colors,
                                             std::vector<int>(graph->nb_vertices, 0));
 
@@ -262,16 +316,124 @@ void Solution::init_deltas_optimized() {
             }
         }
     }
+    _deltas_up_to_date = true;
 }
 
 void Solution::init_possible_colors() {
     _possible_colors = std::vector<std::vector<int>>(graph->nb_vertices);
+    _free_vertices.clear();
+    _free_vertices_position.assign(graph->nb_vertices, -1);
+    _nb_free_neighbors.assign(graph->nb_vertices, 0);
     for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
         for (int color = 0; color < _nb_colors; ++color) {
             if (_conflicts[color][vertex] == 0 and color != _colors[vertex]) {
                 _possible_colors[vertex].emplace_back(color);
             }
         }
+        update_free_vertex(vertex);
+    }
+}
+
+void Solution::init_edge_weights() {
+    // move_to_color_edge does not update the deltas of tabu col
+    _deltas.clear();
+    _deltas_up_to_date = false;
+    size_t nb_edges = 0;
+    for (const auto &neighborhood : graph->neighborhood) {
+        nb_edges += neighborhood.size();
+    }
+    _edge_weights.assign(nb_edges / 2, 1);
+    compute_weighted_conflicts();
+}
+
+void Solution::compute_weighted_conflicts() {
+    _weighted_conflicts.resize(_nb_colors);
+    for (auto &weighted_conflicts : _weighted_conflicts) {
+        weighted_conflicts.assign(graph->nb_vertices, 0);
+    }
+    _weighted_penalty = 0;
+    const auto &indices = graph->edge_indices;
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        const auto &neighborhood = graph->neighborhood[vertex];
+        for (size_t i = 0; i < neighborhood.size(); ++i) {
+            const int neighbor_color = _colors[neighborhood[i]];
+            if (neighbor_color == -1) {
+                continue;
+            }
+            const int weight = _edge_weights[indices[vertex][i]];
+            _weighted_conflicts[neighbor_color][vertex] += weight;
+            if (neighbor_color == _colors[vertex] and vertex < neighborhood[i]) {
+                _weighted_penalty += weight;
+            }
+        }
+    }
+}
+
+void Solution::increase_edge_weights() {
+    const auto &indices = graph->edge_indices;
+    for (const int vertex : _conflicting_vertices) {
+        const int color = _colors[vertex];
+        const auto &neighborhood = graph->neighborhood[vertex];
+        for (size_t i = 0; i < neighborhood.size(); ++i) {
+            const int neighbor = neighborhood[i];
+            // each conflicting edge once, from its smaller vertex
+            if (_colors[neighbor] != color or neighbor < vertex) {
+                continue;
+            }
+            ++_edge_weights[indices[vertex][i]];
+            ++_weighted_conflicts[color][vertex];
+            ++_weighted_conflicts[color][neighbor];
+            ++_weighted_penalty;
+        }
+    }
+}
+
+void Solution::smooth_edge_weights() {
+    const int nb_edges = static_cast<int>(_edge_weights.size());
+    _weight_losses.resize(_edge_weights.size());
+    int *weights = _edge_weights.data();
+    int *losses = _weight_losses.data();
+#pragma omp simd
+    for (int edge = 0; edge < nb_edges; ++edge) {
+        losses[edge] = weights[edge] >> 1;
+        weights[edge] -= losses[edge];
+    }
+    // remove the loss of each edge from the weighted conflicts of its two vertices
+    const auto &indices = graph->edge_indices;
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        const auto &neighborhood = graph->neighborhood[vertex];
+        for (size_t i = 0; i < neighborhood.size(); ++i) {
+            const int neighbor_color = _colors[neighborhood[i]];
+            if (neighbor_color == -1) {
+                continue;
+            }
+            const int loss = losses[indices[vertex][i]];
+            _weighted_conflicts[neighbor_color][vertex] -= loss;
+            if (neighbor_color == _colors[vertex] and vertex < neighborhood[i]) {
+                _weighted_penalty -= loss;
+            }
+        }
+    }
+}
+
+void Solution::update_free_vertex(const int vertex) {
+    const bool is_free = _colors[vertex] != -1 and not _possible_colors[vertex].empty();
+    const int position = _free_vertices_position[vertex];
+    if (is_free and position == -1) {
+        _free_vertices_position[vertex] = static_cast<int>(_free_vertices.size());
+        _free_vertices.emplace_back(vertex);
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            ++_nb_free_neighbors[neighbor];
+        }
+    } else if (not is_free and position != -1) {
+        const int last_vertex = _free_vertices.back();
+        _free_vertices[position] = last_vertex;
+        _free_vertices_position[last_vertex] = position;
+        _free_vertices.pop_back();
+        _free_vertices_position[vertex] = -1;
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            --_nb_free_neighbors[neighbor];
+        }
     }
 }
 
@@ -280,11 +442,26 @@ void Solution::remove_penalty() {
         const int vertex = _conflicting_vertices[0];
         delete_from_color(vertex);
     }
+    // a color emptied before the last one would leave a hole in the colors
+    for (int color = 0; color < _nb_colors; ++color) {
+        if (_color_size[color] == 0) {
+            const auto id_ = id;
+            const int age_ = age;
+            *this = reduce_nb_colors_partial_legal(_nb_colors);
+            id = id_;
+            age = age_;
+            break;
+        }
+    }
     assert(check_solution());
 }
 
 void Solution::color_uncolored() {
+    _deltas_up_to_date = false;
     _possible_colors.clear();
+    _free_vertices.clear();
+    _free_vertices_position.clear();
+    _nb_free_neighbors.clear();
     _deltas.clear();
     _best_improve_colors.clear();
     _best_delta.clear();
@@ -302,6 +479,7 @@ void Solution::color_uncolored() {
     }
 }
 void Solution::delete_from_color(const int vertex) {
+    _deltas_up_to_date = false;
 
     const int old_color = _colors[vertex];
     _colors[vertex] = -1;
@@ -347,6 +525,8 @@ int Solution::move_to_color(const int vertex, const int new_color) {
     assert(_color_size[new_color] != 0);
 
     _colors[vertex] = new_color;
+    // only _deltas is updated, not the best deltas
+    _deltas_up_to_date = false;
 
     // Update conflict score
     const int nb_conflicts_vertex = _conflicts[old_color][vertex];
@@ -400,7 +580,9 @@ int Solution::move_to_color(const int vertex, const int new_color) {
 int Solution::move_to_color_optimized(const int vertex, const int new_color) {
     assert(check_solution());
 
+    const bool deltas_up_to_date = _deltas_up_to_date;
     const int old_color = move_to_color(vertex, new_color);
+    _deltas_up_to_date = deltas_up_to_date;
     for (const auto &neighbor : graph->neighborhood[vertex]) {
         // as the vertex leave//enter the color every delta updates
         if (_colors[neighbor] == old_color) {
@@ -448,15 +630,58 @@ int Solution::move_to_color_optimized(const int vertex, const int new_color) {
     return old_color;
 }
 
+int Solution::move_to_color_edge(const int vertex, const int color) {
+    const int old_color = _colors[vertex];
+    assert(old_color != -1);
+    assert(color >= 0);
+    assert(color < _nb_colors);
+    assert(not _weighted_conflicts.empty());
+
+    _colors[vertex] = color;
+    _deltas_up_to_date = false;
+
+    const int nb_conflicts_vertex = _conflicts[old_color][vertex];
+    const int new_nb_conflicts_vertex = _conflicts[color][vertex];
+    _penalty += new_nb_conflicts_vertex - nb_conflicts_vertex;
+    _weighted_penalty +=
+        _weighted_conflicts[color][vertex] - _weighted_conflicts[old_color][vertex];
+
+    if (nb_conflicts_vertex != 0 and new_nb_conflicts_vertex == 0) {
+        erase_sorted(_conflicting_vertices, vertex);
+    } else if (nb_conflicts_vertex == 0 and new_nb_conflicts_vertex != 0) {
+        insert_sorted(_conflicting_vertices, vertex);
+    }
+
+    // update conflicts and weighted conflicts for neighbors
+    const auto &neighborhood = graph->neighborhood[vertex];
+    const auto &indices = graph->edge_indices[vertex];
+    for (size_t i = 0; i < neighborhood.size(); ++i) {
+        const int neighbor = neighborhood[i];
+        const int weight = _edge_weights[indices[i]];
+        // for the old color
+        --_conflicts[old_color][neighbor];
+        _weighted_conflicts[old_color][neighbor] -= weight;
+        if (old_color == _colors[neighbor] and _conflicts[old_color][neighbor] == 0) {
+            erase_sorted(_conflicting_vertices, neighbor);
+        }
+        // for the new color
+        ++_conflicts[color][neighbor];
+        _weighted_conflicts[color][neighbor] += weight;
+        if (color == _colors[neighbor] and _conflicts[color][neighbor] == 1) {
+            insert_sorted(_conflicting_vertices, neighbor);
+        }
+    }
+
+    --_color_size[old_color];
+    ++_color_size[color];
+
+    return old_color;
+}
+
 int Solution::add_to_color(const int vertex, int proposed_color) {
     assert(_colors[vertex] == -1);
-    int color = proposed_color;
-    if (proposed_color == -1) {
-        color = _nb_colors;
-        ++_nb_colors;
-        _color_size.emplace_back(0);
-        _conflicts.emplace_back(graph->nb_vertices, 0);
-    }
+    _deltas_up_to_date = false;
+    const int color = proposed_color == -1 ? add_empty_color() : proposed_color;
 
     _colors[vertex] = color;
     ++_color_size[color];
@@ -480,8 +705,21 @@ int Solution::add_to_color(const int vertex, int proposed_color) {
     return color;
 }
 
+int Solution::add_empty_color() {
+    _color_size.emplace_back(0);
+    if (_spare_conflicts.empty()) {
+        _conflicts.emplace_back(graph->nb_vertices, 0);
+    } else {
+        _conflicts.emplace_back(std::move(_spare_conflicts.back()));
+        _spare_conflicts.pop_back();
+        _conflicts.back().assign(graph->nb_vertices, 0);
+    }
+    return _nb_colors++;
+}
+
 void Solution::grenade_move(const int vertex, const int color) {
     assert(_colors[vertex] == -1);
+    _deltas_up_to_date = false;
     ++_color_size[color];
     _colors[vertex] = color;
 
@@ -565,14 +803,16 @@ void Solution::grenade_move_optimized_2(const int vertex, const int color) {
     erase_sorted(_uncolored, vertex);
 }
 
-void Solution::grenade_move_optimized(const int vertex, const int color) {
-    int old_color = _colors[vertex];
+void Solution::push_grenade_frame(const int vertex, const int color) {
+    _deltas_up_to_date = false;
+    const int old_color = _colors[vertex];
     if (old_color != -1) {
         --_color_size[old_color];
         for (const int neighbor : graph->neighborhood[vertex]) {
             --_conflicts[old_color][neighbor];
             if (_conflicts[old_color][neighbor] == 0) {
                 insert_sorted(_possible_colors[neighbor], old_color);
+                update_free_vertex(neighbor);
             }
         }
     }
@@ -580,37 +820,249 @@ void Solution::grenade_move_optimized(const int vertex, const int color) {
     _colors[vertex] = color;
     ++_color_size[color];
     erase_sorted(_uncolored, vertex);
+    _grenade_stack.emplace_back(GrenadeFrame{vertex, color, old_color, 0, false});
+}
 
-    for (int neighbor : graph->neighborhood[vertex]) {
-        ++_conflicts[color][neighbor];
-        erase_sorted(_possible_colors[neighbor], color);
-        if (_colors[neighbor] == color) {
-            --_color_size[color];
+int Solution::grenade_move_optimized(const int vertex,
+                                     const int color,
+                                     const int max_depth) {
+    assert(_grenade_stack.empty());
+    int cascade_length = 1;
+    push_grenade_frame(vertex, color);
+
+    while (not _grenade_stack.empty()) {
+        const int depth = static_cast<int>(_grenade_stack.size());
+        auto &frame = _grenade_stack.back();
+        const auto &neighborhood = graph->neighborhood[frame.vertex];
+        const int frame_color = frame.color;
+
+        bool moved_neighbor = false;
+        while (frame.neighbor_index < static_cast<int>(neighborhood.size())) {
+            const int neighbor = neighborhood[frame.neighbor_index];
+            if (frame.waiting) {
+                // the neighbor has been moved, finish its visit
+                frame.waiting = false;
+            } else {
+                ++_conflicts[frame_color][neighbor];
+                erase_sorted(_possible_colors[neighbor], frame_color);
+                if (_colors[neighbor] == frame_color) {
+                    // if the neighbor as no possible colors or the cascade is too deep
+                    if (_possible_colors[neighbor].empty() or
+                        (max_depth > 0 and depth >= max_depth)) {
+                        // it is uncolored
+
+                        --_color_size[frame_color];
+                        insert_sorted(_uncolored, neighbor);
+                        _colors[neighbor] = -1;
+
+                        // update _conflicts and possible_colors for neighbors
+                        for (const int neighbor_2 : graph->neighborhood[neighbor]) {
+                            --_conflicts[frame_color][neighbor_2];
+                            if (_conflicts[frame_color][neighbor_2] == 0 and
+                                neighbor_2 != frame.vertex) {
+                                insert_sorted(_possible_colors[neighbor_2], frame_color);
+                                update_free_vertex(neighbor_2);
+                            }
+                        }
+                    } else {
+                        // color the neighbor with a random possible color, the visit of
+                        // the neighbor resumes once its own cascade is done
+                        frame.waiting = true;
+                        ++cascade_length;
+                        // the frame reference is invalidated by the push
+                        push_grenade_frame(neighbor,
+                                           rd::choice(_possible_colors[neighbor]));
+                        moved_neighbor = true;
+                        break;
+                    }
+                }
+            }
+            erase_sorted(_possible_colors[neighbor], frame_color);
+            update_free_vertex(neighbor);
+            ++frame.neighbor_index;
+        }
+        if (moved_neighbor) {
+            continue;
+        }
 
-            // if the neighbor as no possible colors
-            if (_possible_colors[neighbor].empty()) {
-                // it is uncolored
+        erase_sorted(_possible_colors[frame.vertex], frame_color);
+        if (frame.old_color != -1 and _conflicts[frame.old_color][frame.vertex] == 0) {
+            insert_sorted(_possible_colors[frame.vertex], frame.old_color);
+        }
+        update_free_vertex(frame.vertex);
+        _grenade_stack.pop_back();
+    }
+    return cascade_length;
+}
 
-                insert_sorted(_uncolored, neighbor);
-                _colors[neighbor] = -1;
+const std::vector<int> &Solution::kempe_chain(const int vertex, const int color) {
+    assert(_colors[vertex] != -1);
+    assert(_colors[vertex] != color);
+    if (_kempe_stamp.empty()) {
+        _kempe_stamp.assign(graph->nb_vertices, 0);
+        _kempe_chain.reserve(graph->nb_vertices);
+    }
+    ++_kempe_generation;
+    _kempe_color_1 = _colors[vertex];
+    _kempe_color_2 = color;
+
+    // breadth first search, the chain is the queue of the search
+    _kempe_chain.clear();
+    _kempe_chain.emplace_back(vertex);
+    _kempe_stamp[vertex] = _kempe_generation;
+    for (size_t i = 0; i < _kempe_chain.size(); ++i) {
+        const int chain_vertex = _kempe_chain[i];
+        for (const int neighbor : graph->neighborhood[chain_vertex]) {
+            if (_kempe_stamp[neighbor] == _kempe_generation) {
+                continue;
+            }
+            const int neighbor_color = _colors[neighbor];
+            if (neighbor_color == _kempe_color_1 or neighbor_color == _kempe_color_2) {
+                _kempe_stamp[neighbor] = _kempe_generation;
+                _kempe_chain.emplace_back(neighbor);
+            }
+        }
+    }
+    return _kempe_chain;
+}
 
-                // update _conflicts and possible_colors for neighbors
-                for (const int neighbor_2 : graph->neighborhood[neighbor]) {
-                    --_conflicts[color][neighbor_2];
-                    if (_conflicts[color][neighbor_2] == 0 and neighbor_2 != vertex) {
-                        insert_sorted(_possible_colors[neighbor_2], color);
-                    }
-                }
-            } else {
-                // color the neighbor with a random possible color
-                grenade_move_optimized(neighbor, rd::choice(_possible_colors[neighbor]));
+bool Solution::in_kempe_chain(const int vertex) const {
+    return not _kempe_stamp.empty() and _kempe_stamp[vertex] == _kempe_generation;
+}
+
+void Solution::apply_kempe_chain() {
+    // the neighbors of the chain outside of it have other colors so the conflicting
+    // edges stay conflicting, only the conflicts with the two colors change
+    for (const int vertex : _kempe_chain) {
+        const int old_color = _colors[vertex];
+        const int new_color =
+            old_color == _kempe_color_1 ? _kempe_color_2 : _kempe_color_1;
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            --_conflicts[old_color][neighbor];
+            ++_conflicts[new_color][neighbor];
+        }
+        --_color_size[old_color];
+        ++_color_size[new_color];
+    }
+    for (const int vertex : _kempe_chain) {
+        _colors[vertex] =
+            _colors[vertex] == _kempe_color_1 ? _kempe_color_2 : _kempe_color_1;
+    }
+
+    if (_deltas.empty() and _possible_colors.empty()) {
+        return;
+    }
+    // update the vertices of the chain and their neighbors, each one once
+    ++_kempe_generation;
+    for (const int vertex : _kempe_chain) {
+        if (_kempe_stamp[vertex] != _kempe_generation) {
+            _kempe_stamp[vertex] = _kempe_generation;
+            update_vertex_kempe(vertex);
+        }
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            if (_kempe_stamp[neighbor] != _kempe_generation) {
+                _kempe_stamp[neighbor] = _kempe_generation;
+                update_vertex_kempe(neighbor);
+            }
+        }
+    }
+}
+
+int Solution::kempe_chain_move(const int vertex, const int color) {
+    const int size = static_cast<int>(kempe_chain(vertex, color).size());
+    apply_kempe_chain();
+    return size;
+}
+
+void Solution::recolor(const std::vector<Coloration> &colorations) {
+    // remove the vertices from their colors then add them to the new ones, the colors
+    // can become empty in between
+    for (const auto &[vertex, color] : colorations) {
+        const int old_color = _colors[vertex];
+        if (old_color == -1) {
+            continue;
+        }
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            --_conflicts[old_color][neighbor];
+        }
+        --_color_size[old_color];
+        _colors[vertex] = -1;
+    }
+    for (const auto &[vertex, color] : colorations) {
+        assert(color >= 0 and color < _nb_colors);
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            ++_conflicts[color][neighbor];
+        }
+        ++_color_size[color];
+        _colors[vertex] = color;
+        erase_sorted(_uncolored, vertex);
+    }
+    _penalty = 0;
+    _conflicting_vertices.clear();
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        const int color = _colors[vertex];
+        if (color != -1 and _conflicts[color][vertex] != 0) {
+            _penalty += _conflicts[color][vertex];
+            _conflicting_vertices.emplace_back(vertex);
+        }
+    }
+    // each conflicting edge is counted from its two vertices
+    _penalty /= 2;
+
+    if (_deltas.empty() and _possible_colors.empty()) {
+        return;
+    }
+    // update the vertices and their neighbors, each one once
+    if (_kempe_stamp.empty()) {
+        _kempe_stamp.assign(graph->nb_vertices, 0);
+    }
+    ++_kempe_generation;
+    for (const auto &coloration : colorations) {
+        const int vertex = coloration.vertex;
+        if (_kempe_stamp[vertex] != _kempe_generation) {
+            _kempe_stamp[vertex] = _kempe_generation;
+            update_vertex_kempe(vertex);
+        }
+        for (const int neighbor : graph->neighborhood[vertex]) {
+            if (_kempe_stamp[neighbor] != _kempe_generation) {
+                _kempe_stamp[neighbor] = _kempe_generation;
+                update_vertex_kempe(neighbor);
+            }
+        }
+    }
+}
+
+void Solution::update_vertex_kempe(const int vertex) {
+    const int current_color = _colors[vertex];
+    if (not _deltas.empty()) {
+        const int current =
+            current_color == -1 ? 0 : _conflicts[current_color][vertex];
+        for (int color = 0; color < _nb_colors; ++color) {
+            _deltas[color][vertex] = _conflicts[color][vertex] - current;
+        }
+    }
+    if (_deltas_up_to_date) {
+        _best_delta[vertex] = graph->nb_vertices;
+        _best_improve_colors[vertex].clear();
+        for (int color = 0; color < _nb_colors; ++color) {
+            const int delta = _deltas[color][vertex];
+            if (delta < _best_delta[vertex]) {
+                _best_delta[vertex] = delta;
+                _best_improve_colors[vertex].clear();
+            }
+            if (delta == _best_delta[vertex]) {
+                _best_improve_colors[vertex].emplace_back(color);
             }
         }
-        erase_sorted(_possible_colors[neighbor], color);
     }
-    erase_sorted(_possible_colors[vertex], color);
-    if (old_color != -1 and _conflicts[old_color][vertex] == 0) {
-        insert_sorted(_possible_colors[vertex], old_color);
+    if (not _possible_colors.empty()) {
+        _possible_colors[vertex].clear();
+        for (int color = 0; color < _nb_colors; ++color) {
+            if (_conflicts[color][vertex] == 0 and color != current_color) {
+                _possible_colors[vertex].emplace_back(color);
+            }
+        }
+        update_free_vertex(vertex);
     }
 }
 
@@ -673,6 +1125,18 @@ bool Solution::check_solution() const {
         }
         if (not _possible_colors.empty()) {
             assert(possible_colors == _possible_colors[vertex]);
+            const bool is_free = current_color != -1 and not possible_colors.empty();
+            (void)is_free; // only used in assert
+            assert(is_free == (_free_vertices_position[vertex] != -1));
+            assert(not is_free or
+                   _free_vertices[_free_vertices_position[vertex]] == vertex);
+            int nb_free_neighbors = 0;
+            for (const auto neighbor : graph->neighborhood[vertex]) {
+                if (_free_vertices_position[neighbor] != -1) {
+                    ++nb_free_neighbors;
+                }
+            }
+            assert(nb_free_neighbors == _nb_free_neighbors[vertex]);
         }
         if (not _best_improve_colors.empty()) {
             assert(best_colors == _best_improve_colors[vertex]);
@@ -682,6 +1146,38 @@ bool Solution::check_solution() const {
         }
     }
     assert(nb_uncolored == static_cast<int>(_uncolored.size()));
+    std::vector<int> color_size(_color_size.size(), 0);
+    for (const int color : _colors) {
+        if (color != -1) {
+            ++color_size[static_cast<size_t>(color)];
+        }
+    }
+    assert(color_size == _color_size);
+    return true;
+}
+
+bool Solution::check_edge_weights() const {
+    const auto &indices = graph->edge_indices;
+    int weighted_penalty = 0;
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        std::vector<int> weighted_conflicts(_nb_colors, 0);
+        const auto &neighborhood = graph->neighborhood[vertex];
+        for (size_t i = 0; i < neighborhood.size(); ++i) {
+            const int neighbor = neighborhood[i];
+            const int weight = _edge_weights[indices[vertex][i]];
+            assert(weight >= 1);
+            if (_colors[neighbor] != -1) {
+                weighted_conflicts[_colors[neighbor]] += weight;
+            }
+            if (_colors[neighbor] == _colors[vertex] and vertex < neighbor) {
+                weighted_penalty += weight;
+            }
+        }
+        for (int color = 0; color < _nb_colors; ++color) {
+            assert(weighted_conflicts[color] == _weighted_conflicts[color][vertex]);
+        }
+    }
+    assert(weighted_penalty == _weighted_penalty);
     return true;
 }
 
@@ -742,6 +1238,15 @@ int Solution::delta_conflicts_colors(const int vertex, const int color) const {
     return _deltas[color][vertex];
 }
 
+int Solution::weighted_delta(const int vertex, const int color) const {
+    return _weighted_conflicts[color][vertex] -
+           _weighted_conflicts[_colors[vertex]][vertex];
+}
+
+int Solution::weighted_penalty() const {
+    return _weighted_penalty;
+}
+
 int Solution::nb_conflicts(const int vertex) const {
     return _conflicts[_colors[vertex]][vertex];
 }
@@ -762,6 +1267,22 @@ const std::vector<int> &Solution::possible_colors(const int vertex) const {
     return _possible_colors[vertex];
 }
 
+int Solution::nb_free_colors(const int vertex) const {
+    return static_cast<int>(_possible_colors[vertex].size());
+}
+
+bool Solution::deltas_up_to_date() const {
+    return _deltas_up_to_date;
+}
+
+const std::vector<int> &Solution::free_vertices() const {
+    return _free_vertices;
+}
+
+int Solution::nb_free_neighbors(const int vertex) const {
+    return _nb_free_neighbors[vertex];
+}
+
 void Solution::to_legal() {
     while (not _conflicting_vertices.empty()) {
         int vertex = _conflicting_vertices.back();
@@ -791,6 +1312,28 @@ void Solution::increment_first_free_vertex() {
     ++_first_free_vertex;
 }
 
+[[nodiscard]] uint64_t Solution::fingerprint() const {
+    std::vector<int> labels(_nb_colors, -1);
+    int nb_labels = 0;
+    // FNV-1a on the labels of the vertices
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        const int color = _colors[vertex];
+        int label = -1;
+        if (color != -1) {
+            if (labels[color] == -1) {
+                labels[color] = nb_labels++;
+            }
+            label = labels[color];
+        }
+        hash = (hash ^ static_cast<uint64_t>(label + 1)) * 0x100000001b3ULL;
+    }
+    // final mix (splitmix64) so close partitions give far hashes
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
 std::string Solution::format() const {
 #ifdef DEBUG
     return fmt::format("{},{},{}",
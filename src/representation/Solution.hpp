@@ -1,6 +1,7 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -21,17 +22,34 @@ struct Coloration {
  */
 class Solution {
 
-    /** @brief counter of solutions */
-    static ulong counter;
+    /** @brief counter of solutions, incremented by the constructors of all the threads
+     * (relaxed, only the uniqueness of the ids matters) */
+    static std::atomic<ulong> counter;
 
   public:
-    /** @brief ID of the solution.
-     * Warning! local search can create new solutions (when use_target is false)
-     * be careful if launched in parallel and distance are useful*/
+    /** @brief ID of the solution, unique even for solutions created in parallel, a copy
+     * keeps the ID.
+     * Warning! local search can create new solutions (when use_target is false)*/
     ulong id;
 
-    static int best_penalty;
-    static int best_nb_colors;
+    /** @brief best penalty and best number of colors found by all the threads, lowered
+     * with update_best_penalty and update_best_nb_colors */
+    static std::atomic<int> best_penalty;
+    static std::atomic<int> best_nb_colors;
+
+    /**
+     * @brief Lower the best penalty to the penalty if it is better
+     *
+     * @return true if the best penalty has been lowered
+     */
+    static bool update_best_penalty(const int penalty);
+
+    /**
+     * @brief Lower the best number of colors to nb_colors if it is better
+     *
+     * @return true if the best number of colors has been lowered
+     */
+    static bool update_best_nb_colors(const int nb_colors);
 
   private:
     /** @brief for each vertex, its color */
@@ -46,11 +64,21 @@ class Solution {
     std::vector<int> _color_size{};
     /** @brief for each color, for each vertex, its number of conflicts */
     std::vector<std::vector<int>> _conflicts{};
+    /** @brief rows of _conflicts kept by reset for the next colors */
+    std::vector<std::vector<int>> _spare_conflicts{};
     /** @brief set of each vertex in conflicts (sorted vector) */
     std::vector<int> _conflicting_vertices{};
 
-    // /** @brief for each vertex, the number of available colors */
-    // std::vector<int> _nb_free_colors{};
+    /** @brief set of colored vertices with at least one possible color (unsorted, each
+     * vertex at its position in _free_vertices_position)
+     * for partial ts */
+    std::vector<int> _free_vertices{};
+    /** @brief for each vertex, its position in _free_vertices, -1 if not in it
+     * for partial ts */
+    std::vector<int> _free_vertices_position{};
+    /** @brief for each vertex, its number of neighbors in _free_vertices
+     * for partial ts */
+    std::vector<int> _nb_free_neighbors{};
 
     /** @brief for each color, for each vertex
      * the cost on the penalty if its moved there
@@ -62,6 +90,23 @@ class Solution {
     /** @brief for each vertex, set of best colors (vector of sorted vector)
      * for tabu col optimized */
     std::vector<std::vector<int>> _best_improve_colors{};
+    /** @brief true if _deltas, _best_delta and _best_improve_colors match the colors,
+     * set by init_deltas_optimized, kept by move_to_color_optimized and
+     * grenade_move_optimized_2, reset by the other moves */
+    bool _deltas_up_to_date{false};
+    /** @brief for each edge, its weight
+     * for tabu edge */
+    std::vector<int> _edge_weights{};
+    /** @brief for each edge, the weight removed by the last smoothing
+     * for tabu edge */
+    std::vector<int> _weight_losses{};
+    /** @brief for each color, for each vertex, sum of the weights of its edges to the
+     * vertices of the color (weighted _conflicts)
+     * for tabu edge */
+    std::vector<std::vector<int>> _weighted_conflicts{};
+    /** @brief sum of the weights of the conflicting edges
+     * for tabu edge */
+    int _weighted_penalty{0};
     /** @brief for each vertex, set of possible colors (vector of sorted vector)
      * for partial col optimized */
     std::vector<std::vector<int>> _possible_colors{};
@@ -69,18 +114,66 @@ class Solution {
     /** @brief Next vertex to color in the MCTS tree*/
     int _first_free_vertex{0};
 
+    /** @brief Vertex moved by a grenade move, with its next neighbor to visit*/
+    struct GrenadeFrame {
+        int vertex;
+        int color;
+        int old_color;
+        int neighbor_index;
+        /** @brief true while the neighbor at neighbor_index is being moved*/
+        bool waiting;
+    };
+
+    /** @brief Work stack of grenade_move_optimized, empty between two moves*/
+    std::vector<GrenadeFrame> _grenade_stack{};
+
+    /**
+     * @brief Move the vertex to the color and push it on the grenade stack
+     */
+    void push_grenade_frame(const int vertex, const int color);
+
+    /** @brief Kempe chain computed by kempe_chain, also used as the BFS frontier*/
+    std::vector<int> _kempe_chain{};
+    /** @brief the two colors of the Kempe chain*/
+    int _kempe_color_1{-1};
+    int _kempe_color_2{-1};
+    /** @brief for each vertex, last generation it was visited, kept between the calls*/
+    std::vector<unsigned> _kempe_stamp{};
+    unsigned _kempe_generation{0};
+
+    /**
+     * @brief Update the deltas and possible colors of the vertex after a change of its
+     * conflicts or of its color by a Kempe chain or a recoloring
+     */
+    void update_vertex_kempe(const int vertex);
+
+    /**
+     * @brief Compute the weighted conflicts and the weighted penalty from the edge
+     * weights
+     */
+    void compute_weighted_conflicts();
+
+    /**
+     * @brief Add or remove the vertex from the free vertices according to its color and
+     * possible colors, to call after each change of them
+     */
+    void update_free_vertex(const int vertex);
+
   public:
     /** @brief Age of the solution for the memetic algorithm */
     int age = 0;
 
-    /** @brief map of distances to other solutions in the population, see warning for id*/
-    std::map<u_long, int> distances;
-
     /** @brief Header csv*/
     const static std::string header_csv;
 
     Solution();
 
+    /**
+     * @brief Uncolor all the vertices, the solution is then like a new one (new id, age
+     * 0) but keeps its buffers to be filled again without allocation
+     */
+    void reset();
+
     /**
      * @brief Convert a solution under the form of a group of colors
      *
@@ -108,25 +201,40 @@ class Solution {
      */
     void init_deltas_optimized();
 
+    /**
+     * @brief Return true if the deltas of init_deltas_optimized are still valid, so a
+     * local search can resume without initializing them again
+     */
+    bool deltas_up_to_date() const;
+
     void init_partial_col_optimized_2();
-    // /**
-    //  * @brief Init nb free colors for ILSTS
-    //  */
-    // void init_nb_free_colors();
 
     /**
-     * @brief Init conflicts bias, conflicting edges and edge weights for tabu edge
+     * @brief Init the edge weights to 1 and the weighted conflicts for tabu edge, the
+     * deltas of tabu col are dropped as move_to_color_edge does not update them
      */
     void init_edge_weights();
 
     /**
-     * @brief Init possible colors for partial col optimized
+     * @brief Increase by 1 the weight of each conflicting edge
+     */
+    void increase_edge_weights();
+
+    /**
+     * @brief Halve the edge weights (rounded up) and remove the lost weights from the
+     * weighted conflicts
+     */
+    void smooth_edge_weights();
+
+    /**
+     * @brief Init possible colors and free vertices for partial col optimized and
+     * partial ts
      */
     void init_possible_colors();
 
     /**
-     * @brief Remove color to vertices in conflicts to obtain a partial legal solution
-     *
+     * @brief Remove color to vertices in conflicts to obtain a partial legal solution,
+     * the colors are compacted if some of them become empty
      */
     void remove_penalty();
 
@@ -161,7 +269,7 @@ class Solution {
 
     /**
      * @brief Delete the vertex from its old color and move it to the new one
-     * while updating best_improve_color and best_improve_conflicts
+     * while updating the weighted conflicts
      * and return its old color
      * for tabu edge
      */
@@ -174,6 +282,11 @@ class Solution {
      */
     int add_to_color(const int vertex, int proposed_color);
 
+    /**
+     * @brief Add an empty color and return it, to copy a partition with empty classes
+     */
+    int add_empty_color();
+
     /**
      * @brief Add the vertex to the color while removing its neighbors from the color
      *
@@ -184,12 +297,57 @@ class Solution {
 
     /**
      * @brief Grenade move the vertex to the color and its neighbors to other random
-     * colors, one neighbor can be uncolored at the end. For partial col optimized
+     * colors, one neighbor can be uncolored at the end. For partial ts
+     *
+     * The cascade of moves is processed on an explicit stack. With max_depth > 0, the
+     * neighbors to move beyond this depth are uncolored instead.
+     *
+     * @return int number of vertices moved by the cascade
+     */
+    int grenade_move_optimized(const int vertex,
+                               const int color,
+                               const int max_depth = 0);
+
+    /**
+     * @brief Compute the Kempe chain of the vertex with the color, the connected
+     * component of the vertex in the subgraph of the vertices colored with its color or
+     * with the color. The chain is valid until the next call.
+     */
+    const std::vector<int> &kempe_chain(const int vertex, const int color);
+
+    /**
+     * @brief Return true if the vertex is in the last computed Kempe chain
+     */
+    bool in_kempe_chain(const int vertex) const;
+
+    /**
+     * @brief Swap the two colors of the vertices of the last computed Kempe chain,
+     * the conflicts, the deltas and the possible colors are updated, the penalty and the
+     * uncolored vertices do not change
+     */
+    void apply_kempe_chain();
+
+    /**
+     * @brief Compute and apply the Kempe chain of the vertex with the color
+     *
+     * @return int size of the chain
+     */
+    int kempe_chain_move(const int vertex, const int color);
+
+    /**
+     * @brief Give at once new colors (not -1) to distinct vertices, colored or not, the
+     * conflicts, the deltas and the possible colors are updated
      */
-    void grenade_move_optimized(const int vertex, const int color);
+    void recolor(const std::vector<Coloration> &colorations);
 
     bool check_solution() const;
 
+    /**
+     * @brief Check the weighted conflicts and the weighted penalty against the edge
+     * weights
+     */
+    bool check_edge_weights() const;
+
     /**
      * @brief List the colors where the vertex can be added while adding the least number
      * of conflicts as possible (no new colors)
@@ -219,6 +377,13 @@ class Solution {
 
     int delta_conflicts_colors(const int vertex, const int color) const;
 
+    /**
+     * @brief Variation of the weighted penalty if the vertex moves to the color
+     */
+    int weighted_delta(const int vertex, const int color) const;
+
+    int weighted_penalty() const;
+
     /**
      * @brief Number of conflicts for the vertex in the current color
      */
@@ -235,6 +400,21 @@ class Solution {
 
     const std::vector<int> &possible_colors(const int vertex) const;
 
+    /**
+     * @brief Number of colors where the vertex can move without conflicts
+     */
+    int nb_free_colors(const int vertex) const;
+
+    /**
+     * @brief Colored vertices with at least one possible color (unsorted)
+     */
+    const std::vector<int> &free_vertices() const;
+
+    /**
+     * @brief Number of neighbors of the vertex that are free vertices
+     */
+    int nb_free_neighbors(const int vertex) const;
+
     const std::vector<int> &colors() const;
 
     int first_free_vertex() const;
@@ -247,6 +427,12 @@ class Solution {
      * @brief format to csv
      */
     std::string format() const;
+
+    /**
+     * @brief Hash of the partition of the vertices in O(n), the same for any numbering of
+     * the colors (the colors are relabelled in the order of their smallest vertex)
+     */
+    [[nodiscard]] uint64_t fingerprint() const;
 };
 
 /**
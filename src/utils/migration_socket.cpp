@@ -0,0 +1,162 @@
+#include "migration_socket.hpp"
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <netdb.h>
+#include <stdexcept>
+#include <unistd.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#include <fmt/printf.h>
+#pragma GCC diagnostic pop
+
+#include "../representation/Graph.hpp"
+#include "../representation/Parameters.hpp"
+
+using namespace graph_instance;
+using namespace parameters_search;
+
+namespace {
+/** @brief first word of a datagram ("GCP1")*/
+constexpr uint32_t magic = 0x47435031;
+/** @brief color of an uncolored vertex in a datagram*/
+constexpr uint16_t uncolored = 0xFFFF;
+/** @brief words before the colors*/
+constexpr size_t header_size = 3 * sizeof(uint32_t);
+/** @brief largest payload of a UDP datagram*/
+constexpr size_t max_datagram = 65507;
+
+size_t datagram_size() {
+    return header_size + sizeof(uint16_t) * static_cast<size_t>(graph->nb_vertices);
+}
+
+void write_uint32(std::vector<uint8_t> &buffer,
+                  const size_t offset,
+                  const uint32_t value) {
+    const uint32_t word = htonl(value);
+    std::memcpy(buffer.data() + offset, &word, sizeof(word));
+}
+
+uint32_t read_uint32(const std::vector<uint8_t> &buffer, const size_t offset) {
+    uint32_t word;
+    std::memcpy(&word, buffer.data() + offset, sizeof(word));
+    return ntohl(word);
+}
+} // namespace
+
+MigrationSocket::MigrationSocket(const int port, const std::vector<std::string> &peers)
+    : _socket(::socket(AF_INET, SOCK_DGRAM, 0)), _peers() {
+    if (_socket == -1) {
+        throw std::runtime_error(
+            fmt::format("error while creating the migration socket : {}\n",
+                        std::strerror(errno)));
+    }
+    if (datagram_size() > max_datagram) {
+        ::close(_socket);
+        throw std::runtime_error(fmt::format(
+            "{} vertices do not fit in a migration datagram\n", graph->nb_vertices));
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::bind(_socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) ==
+        -1) {
+        const std::string error = std::strerror(errno);
+        ::close(_socket);
+        throw std::runtime_error(
+            fmt::format("error while binding the migration port {} : {}\n", port, error));
+    }
+    for (const auto &peer : peers) {
+        const auto separator = peer.rfind(':');
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo *result = nullptr;
+        if (separator == std::string::npos or
+            ::getaddrinfo(peer.substr(0, separator).c_str(),
+                          peer.substr(separator + 1).c_str(),
+                          &hints,
+                          &result) != 0) {
+            ::close(_socket);
+            throw std::runtime_error(
+                fmt::format("error while resolving the peer {} (host:port)\n", peer));
+        }
+        Peer resolved{};
+        std::memcpy(&resolved.address, result->ai_addr, result->ai_addrlen);
+        resolved.length = result->ai_addrlen;
+        _peers.emplace_back(resolved);
+        ::freeaddrinfo(result);
+    }
+}
+
+MigrationSocket::~MigrationSocket() {
+    ::close(_socket);
+}
+
+int MigrationSocket::nb_peers() const {
+    return static_cast<int>(_peers.size());
+}
+
+void MigrationSocket::send(const Solution &migrant, const int peer) const {
+    std::vector<uint8_t> buffer(datagram_size());
+    write_uint32(buffer, 0, magic);
+    write_uint32(buffer, sizeof(uint32_t), static_cast<uint32_t>(graph->nb_vertices));
+    write_uint32(buffer, 2 * sizeof(uint32_t), static_cast<uint32_t>(graph->nb_edges));
+    for (int vertex = 0; vertex < graph->nb_vertices; ++vertex) {
+        const uint16_t color = migrant[vertex] == -1
+                                   ? uncolored
+                                   : htons(static_cast<uint16_t>(migrant[vertex]));
+        std::memcpy(buffer.data() + header_size + sizeof(uint16_t) * vertex,
+                    &color,
+                    sizeof(color));
+    }
+    // best effort, a migrant that can not be sent is lost
+    ::sendto(_socket,
+             buffer.data(),
+             buffer.size(),
+             0,
+             reinterpret_cast<const sockaddr *>(&_peers[peer].address),
+             _peers[peer].length);
+}
+
+[[nodiscard]] std::optional<Solution> MigrationSocket::receive() const {
+    std::vector<uint8_t> buffer(datagram_size());
+    while (true) {
+        const ssize_t size = ::recvfrom(
+            _socket, buffer.data(), buffer.size(), MSG_DONTWAIT, nullptr, nullptr);
+        if (size < 0) {
+            return std::nullopt;
+        }
+        // datagram of another graph
+        if (static_cast<size_t>(size) != buffer.size() or
+            read_uint32(buffer, 0) != magic or
+            read_uint32(buffer, sizeof(uint32_t)) !=
+                static_cast<uint32_t>(graph->nb_vertices) or
+            read_uint32(buffer, 2 * sizeof(uint32_t)) !=
+                static_cast<uint32_t>(graph->nb_edges)) {
+            continue;
+        }
+        // the colors of the datagram are renumbered in their order of appearance
+        Solution migrant;
+        std::vector<int> colors(parameters->nb_colors, -1);
+        bool valid = true;
+        for (int vertex = 0; vertex < graph->nb_vertices and valid; ++vertex) {
+            uint16_t color;
+            std::memcpy(&color,
+                        buffer.data() + header_size + sizeof(uint16_t) * vertex,
+                        sizeof(color));
+            color = ntohs(color);
+            if (color == uncolored or color >= colors.size()) {
+                valid = false;
+            } else {
+                colors[color] = migrant.add_to_color(vertex, colors[color]);
+            }
+        }
+        if (valid and
+            (migrant.nb_colors() == parameters->nb_colors or migrant.penalty() == 0)) {
+            return migrant;
+        }
+    }
+}
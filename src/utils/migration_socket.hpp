@@ -0,0 +1,57 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+#include "../representation/Solution.hpp"
+
+/**
+ * @brief UDP socket exchanging migrants between processes (on one or several machines)
+ *
+ * A migrant is sent in one datagram, in network byte order :
+ * uint32 magic, uint32 nb vertices, uint32 nb edges, then the color of each vertex
+ * as a uint16 (0xFFFF for an uncolored vertex).
+ * The datagrams are best effort, a lost migrant is not sent again. A datagram of another
+ * graph, or a coloring not complete with the number of colors of the search (unless it is
+ * legal), is ignored.
+ */
+class MigrationSocket {
+
+    /** @brief address of a peer*/
+    struct Peer {
+        sockaddr_storage address;
+        socklen_t length;
+    };
+
+    int _socket;
+    std::vector<Peer> _peers;
+
+  public:
+    /**
+     * @brief Bind the port on all the interfaces and resolve the peers (host:port)
+     *
+     * @throw std::runtime_error if the socket can not be created or bound or if a peer
+     * can not be resolved
+     */
+    MigrationSocket(const int port, const std::vector<std::string> &peers);
+
+    ~MigrationSocket();
+
+    MigrationSocket(const MigrationSocket &other) = delete;
+    MigrationSocket &operator=(const MigrationSocket &other) = delete;
+
+    int nb_peers() const;
+
+    /**
+     * @brief Send the migrant to the peer, without waiting for it
+     */
+    void send(const Solution &migrant, const int peer) const;
+
+    /**
+     * @brief Return the next migrant received, without waiting, std::nullopt if there is
+     * none
+     */
+    [[nodiscard]] std::optional<Solution> receive() const;
+};
@@ -35,6 +35,14 @@ std::shared_ptr<AdaptiveHelper> get_adaptive_helper(const json &data,
   std::string name = data["name"];
   int memory_size = data["memory_size"];
   int coeff_exploi_explo = data["coeff_exploi_explo"];
+  // a turn writes nb_selected results from (turn * nb_selected) % memory_size
+  if (memory_size < 1 or memory_size % nb_selected != 0) {
+    fmt::print(stderr,
+               "memory_size of the adaptive helper must be a positive multiple "
+               "of nb_selected ({}) {}\n",
+               nb_selected, data.dump());
+    exit(1);
+  }
 
   ParamAdapt param{name, nb_operators, memory_size, nb_selected,
                    coeff_exploi_explo};
@@ -104,8 +112,12 @@ Crossover get_crossover(const json &data) {
   if (data.contains("colors_p1")) {
     colors_p1 = data["colors_p1"];
   }
-  ParamCrossover param =
-      ParamCrossover{data["name"], data["pseudo"], percentage_p1, colors_p1};
+  int kempe_moves = 10;
+  if (data.contains("kempe_moves")) {
+    kempe_moves = data["kempe_moves"];
+  }
+  ParamCrossover param = ParamCrossover{data["name"], data["pseudo"],
+                                        percentage_p1, colors_p1, kempe_moves};
   if (param.name == "no_crossover")
     return Crossover{no_crossover, param};
   if (param.name == "gpx")
@@ -114,9 +126,12 @@ Crossover get_crossover(const json &data) {
     return Crossover{partial_random_gpx, param};
   if (param.name == "partial_best_gpx")
     return Crossover{partial_best_gpx, param};
+  if (param.name == "kempe_perturbation")
+    return Crossover{kempe_perturbation, param};
   fmt::print(stderr,
              "Unknown crossover {}\nplease select : "
-             "no_crossover, gpx, partial_random_gpx, partial_best_gpx\n",
+             "no_crossover, gpx, partial_random_gpx, partial_best_gpx, "
+             "kempe_perturbation\n",
              param.name);
   exit(1);
 }
@@ -136,16 +151,38 @@ local_search_ptr get_local_search_fct(const std::string &local_search) {
     return tabu_col_optimized;
   if (local_search == "tabu_bucket")
     return tabu_bucket;
+  if (local_search == "iterated_local_search")
+    return iterated_local_search;
+  if (local_search == "kempe_col")
+    return kempe_col;
+  if (local_search == "simulated_annealing")
+    return simulated_annealing;
+  if (local_search == "tabu_edge")
+    return tabu_edge;
   fmt::print(
       stderr,
       "Unknown local_search, please select : "
       "none, partial_col, partial_col_optimized, partial_ts, tabu_bucket, "
-      "tabu_col_optimized,tabu_col\n");
+      "tabu_col_optimized,tabu_col, iterated_local_search, kempe_col, "
+      "simulated_annealing, tabu_edge\n");
+  exit(1);
+}
+
+perturbation_ptr get_perturbation_fct(const std::string &perturbation) {
+  if (perturbation == "random")
+    return perturbation_random;
+  if (perturbation == "kempe")
+    return perturbation_kempe;
+  fmt::print(stderr,
+             "Unknown perturbation, please select : "
+             "random, kempe\n");
   exit(1);
 }
 
 LocalSearch get_local_search(json data, int max_time, bool verbose,
-                             long max_iterations_) {
+                             long max_iterations_,
+                             std::shared_ptr<std::atomic<bool>> cancel,
+                             std::shared_ptr<ParamExchange> exchange) {
   const std::string name = data["name"];
   const std::string pseudo = data["pseudo"];
   if (name == "tabu_bucket" and qgraph == nullptr) {
@@ -159,6 +196,88 @@ LocalSearch get_local_search(json data, int max_time, bool verbose,
     random_min = data["tabu_iter"]["random"]["min"];
     random_max = data["tabu_iter"]["random"]["max"];
   }
+  int scan_threads = 1;
+  int scan_min_vertices = 0;
+  if (data.contains("parallel_scan")) {
+    scan_threads = data["parallel_scan"]["nb_threads"];
+    scan_min_vertices = data["parallel_scan"]["min_vertices"];
+  }
+  std::optional<ParamSampling> sampling = std::nullopt;
+  if (data.contains("sampling")) {
+    sampling.emplace(
+        ParamSampling{data["sampling"]["size"], data["sampling"]["ratio"]});
+  }
+  int max_cascade_depth = 0;
+  if (data.contains("cascade")) {
+    max_cascade_depth = data["cascade"]["max_depth"];
+  }
+  std::optional<ParamFinisher> finisher = std::nullopt;
+  if (data.contains("finisher")) {
+    finisher.emplace(ParamFinisher{data["finisher"]["max_uncolored"],
+                                   data["finisher"]["max_conflicts"],
+                                   data["finisher"]["depth"],
+                                   data["finisher"]["max_vertices"],
+                                   data["finisher"]["max_nodes"],
+                                   data["finisher"]["max_time"]});
+  }
+  std::optional<ParamReactive> reactive = std::nullopt;
+  if (data.contains("reactive")) {
+    reactive.emplace(ParamReactive{data["reactive"]["increase"],
+                                   data["reactive"]["decrease"],
+                                   data["reactive"]["max_repetitions"],
+                                   data["reactive"]["escape_moves"]});
+  }
+  std::optional<ParamAnnealing> annealing = std::nullopt;
+  if (data.contains("annealing")) {
+    annealing.emplace(ParamAnnealing{data["annealing"]["initial_temperature"],
+                                     data["annealing"]["final_temperature"],
+                                     data["annealing"]["cooling"],
+                                     data["annealing"]["plateau"]});
+    if (annealing->cooling <= 0 or annealing->cooling >= 1) {
+      fmt::print(stderr, "annealing cooling must be in ]0, 1[ {}\n",
+                 data.dump());
+      exit(1);
+    }
+    if (annealing->final_temperature <= 0 or
+        annealing->initial_temperature <= annealing->final_temperature) {
+      fmt::print(stderr,
+                 "annealing temperatures must be positive with "
+                 "initial_temperature > final_temperature {}\n",
+                 data.dump());
+      exit(1);
+    }
+    if (annealing->plateau < 1) {
+      fmt::print(stderr, "annealing plateau must be at least 1 {}\n",
+                 data.dump());
+      exit(1);
+    }
+  } else if (name == "simulated_annealing") {
+    fmt::print(stderr, "simulated_annealing needs an annealing schedule {}\n",
+               data.dump());
+    exit(1);
+  }
+  int edge_smoothing = 0;
+  if (data.contains("edge_weights")) {
+    edge_smoothing = data["edge_weights"]["smoothing"];
+  }
+  long stagnation_iterations = 0;
+  long stagnation_time = 0;
+  if (data.contains("stagnation")) {
+    stagnation_iterations = data["stagnation"]["iterations"];
+    stagnation_time = data["stagnation"]["time"];
+  }
+  std::shared_ptr<const ParamILS> ils = nullptr;
+  if (name == "iterated_local_search") {
+    std::string perturbation_type = "random";
+    if (data.contains("perturbation_type")) {
+      perturbation_type = data["perturbation_type"];
+    }
+    ils = std::make_shared<const ParamILS>(
+        ParamILS{get_local_search(data["local_search"], max_time, false,
+                                  max_iterations_, cancel),
+                 data["perturbation"],
+                 get_perturbation_fct(perturbation_type)});
+  }
   long max_iterations = max_iterations_;
   if (data.contains("time")) {
     if (data["time"].contains("relative")) {
@@ -177,7 +296,11 @@ LocalSearch get_local_search(json data, int max_time, bool verbose,
   }
   return LocalSearch(get_local_search_fct(name),
                      ParamLS{name, pseudo, alpha, random_min, random_max,
-                             max_time, max_iterations, verbose});
+                             max_time, max_iterations, verbose, scan_threads,
+                             scan_min_vertices, sampling, max_cascade_depth,
+                             finisher, reactive, annealing, edge_smoothing,
+                             stagnation_iterations, stagnation_time, ils,
+                             cancel, exchange});
 }
 
 selection_ptr get_selection_fct(const std::string &name) {
@@ -266,6 +389,27 @@ ParamMA get_memetic(json data, int max_time, long max_iterations_) {
   if (data.contains("elites")) {
     elites = data["elites"];
   }
+  bool steady_state = false;
+  if (data.contains("steady_state")) {
+    steady_state = data["steady_state"];
+  }
+  if (steady_state and (data["insertion"]["name"] == "insertion_head" or
+                        data["adaptive"]["name"] == "neural_net")) {
+    fmt::print(stderr,
+               "steady_state memetic needs an insertion by child and an "
+               "adaptive helper without neural_net {}\n",
+               data.dump());
+    exit(1);
+  }
+  int ls_cache = 0;
+  if (data.contains("ls_cache")) {
+    ls_cache = data["ls_cache"];
+  }
+  if (ls_cache < 0) {
+    fmt::print(stderr, "ls_cache must be positive or 0 (disabled) {}\n",
+               data.dump());
+    exit(1);
+  }
   return ParamMA{
       name,
       population_size,
@@ -279,7 +423,9 @@ ParamMA get_memetic(json data, int max_time, long max_iterations_) {
       pairs_x_ls,
       x_ls_names,
       get_adaptive_helper(data["adaptive"], nb_operators, nb_selected),
-      elites};
+      elites,
+      steady_state,
+      ls_cache};
 }
 
 ParamMCTS get_mcts(json data, int max_time, long max_iterations_) {
@@ -324,6 +470,112 @@ ParamMCTS get_mcts(json data, int max_time, long max_iterations_) {
                    get_simulation_fct(data["simulation"]["name"])};
 }
 
+ParamPortfolio get_portfolio(json data, int max_time, long max_iterations_) {
+  const auto cancel = std::make_shared<std::atomic<bool>>(false);
+  int nb_threads = data["nb_threads"];
+  long exchange_interval = 0;
+  int stagnation = 1;
+  int elite_size = 1;
+  double perturbation = 0;
+  json crossover = {{"name", "gpx"}, {"pseudo", "gpx"}};
+  if (data.contains("cooperation")) {
+    exchange_interval = data["cooperation"]["exchange_interval"];
+    stagnation = data["cooperation"]["stagnation"];
+    elite_size = data["cooperation"]["elite_size"];
+    perturbation = data["cooperation"]["perturbation"];
+    if (data["cooperation"].contains("crossover")) {
+      crossover = data["cooperation"]["crossover"];
+    }
+  }
+  if (data["local_search"].empty()) {
+    fmt::print(stderr, "portfolio without local search {}\n", data.dump());
+    exit(1);
+  }
+  std::vector<LocalSearch> local_search;
+  if (exchange_interval > 0) {
+    // each cooperative thread gets its own exchange with the elite pool
+    for (int thread = 0; thread < nb_threads; ++thread) {
+      local_search.emplace_back(get_local_search(
+          data["local_search"][static_cast<size_t>(thread) %
+                               data["local_search"].size()],
+          max_time, false, std::numeric_limits<long>::max(), cancel,
+          std::make_shared<ParamExchange>(ParamExchange{exchange_interval})));
+    }
+  } else {
+    for (auto json_ls : data["local_search"]) {
+      local_search.emplace_back(get_local_search(
+          json_ls, max_time, false, std::numeric_limits<long>::max(), cancel));
+    }
+  }
+  return ParamPortfolio{data["name"],
+                        nb_threads,
+                        max_iterations_,
+                        local_search,
+                        cancel,
+                        exchange_interval,
+                        stagnation,
+                        elite_size,
+                        perturbation,
+                        get_crossover(crossover)};
+}
+
+ParamExtraction get_extraction(json data, int max_time, long max_iterations_) {
+  if (not data.contains("residual_method")) {
+    fmt::print(stderr, "extraction without residual method {}\n", data.dump());
+    exit(1);
+  }
+  return ParamExtraction{data["name"],
+                         data["extraction"]["residual_vertices"],
+                         data["extraction"]["nb_threads"],
+                         data["extraction"]["nb_starts"],
+                         data["extraction"]["max_iterations"],
+                         data["extraction"]["tenure"],
+                         data["residual_method"].dump(),
+                         max_time,
+                         max_iterations_};
+}
+
+ParamIsland get_islands(json data, int max_time, long max_iterations_) {
+  if (not data.contains("memetic") or data["memetic"]["method"] != "memetic") {
+    fmt::print(stderr, "islands without memetic algorithm {}\n", data.dump());
+    exit(1);
+  }
+  if (data["memetic"].contains("steady_state") and
+      data["memetic"]["steady_state"] == true) {
+    fmt::print(stderr, "islands run generational memetic algorithms {}\n",
+               data.dump());
+    exit(1);
+  }
+  const std::string migrant = data["islands"]["migrant"];
+  const std::string topology = data["islands"]["topology"];
+  if ((migrant != "best" and migrant != "distant") or
+      (topology != "ring" and topology != "random")) {
+    fmt::print(stderr,
+               "islands migrant must be best or distant and topology ring or "
+               "random {}\n",
+               data.dump());
+    exit(1);
+  }
+  int port = -1;
+  std::vector<std::string> peers;
+  if (data["islands"].contains("network")) {
+    port = data["islands"]["network"]["port"];
+    for (const auto &peer : data["islands"]["network"]["peers"]) {
+      peers.emplace_back(peer);
+    }
+  }
+  return ParamIsland{data["name"],
+                     data["islands"]["nb_islands"],
+                     data["islands"]["migration_interval"],
+                     migrant == "distant",
+                     topology == "random",
+                     data["memetic"].dump(),
+                     port,
+                     peers,
+                     max_time,
+                     max_iterations_};
+}
+
 std::unique_ptr<Method> get_method(const std::string &json_content,
                                    int max_time, long max_iterations) {
   json data = json::parse(json_content);
@@ -343,9 +595,19 @@ std::unique_ptr<Method> get_method(const std::string &json_content,
     return std::make_unique<MemeticAlgorithm>(
         get_greedy_fct(data["initialization"]),
         get_memetic(data, max_time, max_iterations));
+  } else if (data["method"] == "portfolio") {
+    return std::make_unique<PortfolioAlgorithm>(
+        get_greedy_fct(data["initialization"]),
+        get_portfolio(data, max_time, max_iterations));
   } else if (data["method"] == "mcts") {
     return std::make_unique<MCTS>(get_greedy_fct(data["initialization"]),
                                   get_mcts(data, max_time, max_iterations));
+  } else if (data["method"] == "extraction") {
+    return std::make_unique<ExtractionAlgorithm>(
+        get_extraction(data, max_time, max_iterations));
+  } else if (data["method"] == "islands") {
+    return std::make_unique<IslandModel>(
+        get_islands(data, max_time, max_iterations));
   } else {
     fmt::print(stderr, "unkown method : {}", data["method"]);
     exit(1);
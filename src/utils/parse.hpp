@@ -2,9 +2,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include "../methods/ExtractionAlgorithm.hpp"
+#include "../methods/IslandModel.hpp"
 #include "../methods/LocalSearchAlgorithm.hpp"
 #include "../methods/MCTS.hpp"
 #include "../methods/MemeticAlgorithm.hpp"
+#include "../methods/PortfolioAlgorithm.hpp"
 #include "../representation/Graph.hpp"
 #include "../representation/Method.hpp"
 #include "../representation/Parameters.hpp"
@@ -23,8 +26,12 @@ Crossover get_crossover(const json &data);
 
 local_search_ptr get_local_search_fct(const std::string &local_search);
 
+perturbation_ptr get_perturbation_fct(const std::string &perturbation);
+
 LocalSearch get_local_search(json data, int max_time, bool verbose,
-                             long max_iterations);
+                             long max_iterations,
+                             std::shared_ptr<std::atomic<bool>> cancel = nullptr,
+                             std::shared_ptr<ParamExchange> exchange = nullptr);
 
 selection_ptr get_selection_fct(const std::string &name);
 
@@ -34,5 +41,11 @@ ParamMA get_memetic(json data, int max_time, long max_iterations_);
 
 ParamMCTS get_mcts(json data, int max_time, long max_iterations);
 
+ParamPortfolio get_portfolio(json data, int max_time, long max_iterations_);
+
+ParamExtraction get_extraction(json data, int max_time, long max_iterations_);
+
+ParamIsland get_islands(json data, int max_time, long max_iterations_);
+
 std::unique_ptr<Method> get_method(const std::string &json_content,
                                    int max_time, long max_iterations);
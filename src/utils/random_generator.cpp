@@ -1,6 +1,63 @@
 #include "random_generator.hpp"
 
+#include <atomic>
+
 namespace rd {
+namespace {
+/** @brief seed of the search (set in src/main.cpp)*/
+std::atomic<int> base_seed{0};
+/** @brief number of generators created by the threads*/
+std::atomic<int> nb_generators{0};
+
+/**
+ * @brief Mix the key into the hash (splitmix64 finalizer)
+ */
+uint64_t mix(uint64_t hash, const long key) {
+    hash ^= static_cast<uint64_t>(key) + 0x9e3779b97f4a7c15ULL + (hash << 6) +
+            (hash >> 2);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief Seed the generator with 64 bits
+ */
+void seed_generator(Generator &generator_, const uint64_t seed_) {
+#ifdef RNG_MT19937
+    std::seed_seq seq{static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32)};
+    generator_.seed(seq);
+#else
+    generator_.seed(seed_);
+#endif
+}
+
+/**
+ * @brief Create a generator for a new thread, seeded from the seed of the search and
+ * the number of generators already created
+ */
+Generator new_generator() {
+    Generator generator_;
+    seed_generator(generator_, mix(mix(0, base_seed.load()), nb_generators.fetch_add(1)));
+    return generator_;
+}
+} // namespace
+
 // init generator (set rand seed in src/main.cpp)
-std::mt19937 generator;
+thread_local Generator generator = new_generator();
+
+void seed(const int rand_seed) {
+    base_seed = rand_seed;
+    seed_generator(generator, static_cast<uint64_t>(rand_seed));
+}
+
+void seed_task(const std::initializer_list<long> keys) {
+    // the number of keys is mixed first to keep the streams of the tasks apart from
+    // the streams of the threads
+    uint64_t hash = mix(mix(0, base_seed.load()), -static_cast<long>(keys.size()));
+    for (const long key : keys) {
+        hash = mix(hash, key);
+    }
+    seed_generator(generator, hash);
+}
 } // namespace rd
@@ -1,13 +1,129 @@
 #pragma once
 
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <initializer_list>
 #include <random>
 #include <set>
 #include <vector>
 
 namespace rd {
-/** @brief random number generator*/
-extern std::mt19937 generator;
+
+/**
+ * @brief xoshiro256++ generator, 256 bits of state, 64 bits outputs
+ *
+ * From :
+ * Blackman, David, and Sebastiano Vigna.
+ * Scrambled Linear Pseudorandom Number Generators.
+ * ACM Transactions on Mathematical Software 47, no. 4 (2021): 1–32.
+ */
+class Xoshiro256PlusPlus {
+    std::array<uint64_t, 4> _state{};
+
+    static uint64_t rotl(const uint64_t x, const int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+  public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256PlusPlus(const uint64_t seed_ = 0) {
+        seed(seed_);
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+    /**
+     * @brief Fill the state with splitmix64 from the seed, the state is never all zeros
+     */
+    void seed(uint64_t seed_) {
+        for (auto &word : _state) {
+            seed_ += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = seed_;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    result_type operator()() {
+        const uint64_t result = rotl(_state[0] + _state[3], 23) + _state[0];
+        const uint64_t t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotl(_state[3], 45);
+        return result;
+    }
+};
+
+/** @brief type of the generators, xoshiro256++ or, built with RNG_MT19937,
+ * std::mt19937*/
+#ifdef RNG_MT19937
+using Generator = std::mt19937;
+#else
+using Generator = Xoshiro256PlusPlus;
+#endif
+
+/** @brief random number generator, one per thread
+ * the generators of the threads other than the main one are seeded from the seed given
+ * to rd::seed and their creation order, use seed_task in parallel regions to get random
+ * numbers independent of the threads*/
+extern thread_local Generator generator;
+
+/**
+ * @brief Seed the generator of the current thread and the generators of the threads
+ * that are not yet created
+ *
+ * @param rand_seed random seed
+ */
+void seed(const int rand_seed);
+
+/**
+ * @brief Seed the generator of the current thread with the stream of a task, derived
+ * only from the seed given to rd::seed and the keys of the task (turn, index of the
+ * task...), so the task draws the same numbers whatever the thread running it
+ */
+void seed_task(const std::initializer_list<long> keys);
+
+/**
+ * @brief Keep the generator of the current thread and restore it at the end of the
+ * scope, for the thread starting a parallel region of tasks calling seed_task, so its
+ * own numbers do not depend on the tasks it ran
+ */
+class SavedGenerator {
+    const Generator _generator;
+
+  public:
+    SavedGenerator() : _generator(generator) {}
+
+    ~SavedGenerator() {
+        generator = _generator;
+    }
+
+    SavedGenerator(const SavedGenerator &other) = delete;
+    SavedGenerator &operator=(const SavedGenerator &other) = delete;
+};
+
+/**
+ * @brief Random 32 bits integer from the generator of the current thread
+ */
+inline uint32_t random_uint32() {
+    if constexpr (Generator::max() == UINT32_MAX) {
+        return static_cast<uint32_t>(generator());
+    } else {
+        return static_cast<uint32_t>(generator() >> 32);
+    }
+}
 
 /**
  * @brief Get the random value from a non empty container